@@ -1,4 +1,5 @@
 #pragma once
+#ifdef ARDUINO
 
 #include <Arduino.h>
 #include <FspTimer.h>
@@ -11,8 +12,10 @@ static constexpr unsigned int pin_zero_index = 28;
 
 namespace DirectDrive {
 
-static constexpr uint32_t LED_MATRIX_PORT0_MASK  = ((1 << 3) | (1 << 4) | (1 << 11) | (1 << 12) | (1 << 13) | (1 << 15));
-static constexpr uint32_t LED_MATRIX_PORT2_MASK  = ((1 << 4) | (1 << 5) | (1 << 6) | (1 << 12) | (1 << 13));
+static constexpr uint32_t LED_MATRIX_PORT0_MASK  = line_mask(0);
+static constexpr uint32_t LED_MATRIX_PORT2_MASK  = line_mask(1);
+static_assert(LED_MATRIX_PORT0_MASK == ((1 << 3) | (1 << 4) | (1 << 11) | (1 << 12) | (1 << 13) | (1 << 15)));
+static_assert(LED_MATRIX_PORT2_MASK == ((1 << 4) | (1 << 5) | (1 << 6) | (1 << 12) | (1 << 13)));
 void clear_matrix()  {
   R_PORT0->PCNTR1 &= ~LED_MATRIX_PORT0_MASK;
   R_PORT2->PCNTR1 &= ~LED_MATRIX_PORT2_MASK;
@@ -30,12 +33,43 @@ void deactivate_row(int row)  {
       R_PORT0->PCNTR1 &= ~(1 << (pin_a & 0xFF));
   }
 }
+void write_ports(uint32_t port0, uint32_t port2) {
+  constexpr uint32_t mask0 = LED_MATRIX_PORT0_MASK | (LED_MATRIX_PORT0_MASK << 16);
+  constexpr uint32_t mask2 = LED_MATRIX_PORT2_MASK | (LED_MATRIX_PORT2_MASK << 16);
+  R_PORT0->PCNTR1 = (R_PORT0->PCNTR1 & ~mask0) | port0;
+  R_PORT2->PCNTR1 = (R_PORT2->PCNTR1 & ~mask2) | port2;
+}
+bool check_line_pins() {
+  for (unsigned int i = 0; i < 11; ++i) {
+    bsp_io_port_pin_t pin_a = g_pin_cfg[i + pin_zero_index].pin;
+    const LinePin &lp = line_pins[i];
+    if ((pin_a >> 8) != (lp.port?2U:0U) || (pin_a & 0xFF) != lp.pin) return false;
+  }
+  return true;
+}
 
 
 
 }
 
 
+static TickScheduler<auto_drive_scheduler_capacity> scheduler;
+
+///disables interrupts for its scope, restores previous state (can be nested, used with interrupts disabled)
+class InterruptLock {
+public:
+    InterruptLock():_primask(__get_PRIMASK()) {
+        __disable_irq();
+    }
+    ~InterruptLock() {
+        __set_PRIMASK(_primask);
+    }
+    InterruptLock(const InterruptLock &) = delete;
+    InterruptLock &operator=(const InterruptLock &) = delete;
+protected:
+    uint32_t _primask;
+};
+
 class AutoDriveTimer {
 public:
 
@@ -46,6 +80,7 @@ public:
             if (_freq) {
                 _timer.stop();
                 _timer.close();
+                _base_period = 0;
             }
             if (freq && cb) {
                 uint8_t timer_type = GPT_TIMER;
@@ -55,9 +90,38 @@ public:
                 }
                 _freq = freq;
                 _timer.begin(TIMER_MODE_PERIODIC, timer_type, tindex, freq, 0.0f,
-                        [](auto x){instance->_cb();});
+                        [](timer_callback_args_t *x){
+                    if (x->event == TIMER_EVENT_CAPTURE_A) {
+                        DirectDrive::clear_matrix();
+                    } else {
+                        //interval since the previous interrupt is the period of the tick which ended
+                        unsigned int ended_scale = instance->_cur_scale;
+                        instance->_cur_scale = instance->_scale;
+                        if (instance->_stats) {
+                            instance->_stats->measure(instance->_tick_cycles * ended_scale, [&]{
+                                instance->_cb();
+                                scheduler.advance(instance->_cur_scale);
+                            });
+                        } else {
+                            instance->_cb();
+                            scheduler.advance(instance->_cur_scale);
+                        }
+                    }
+                });
                 _timer.setup_overflow_irq();
+                _timer.setup_capture_a_irq();
                 _timer.open();
+                _base_period = _timer.get_period_raw();
+                _next_period = _base_period;
+                _scale = _cur_scale = 1;
+                _tick_cycles = SystemCoreClock / freq;
+                //compare match stays disabled until brightness is reduced
+                _compare_irq = static_cast<const gpt_extended_cfg_t *>(
+                        _timer.get_cfg()->p_extend)->capture_a_irq;
+                R_BSP_IrqDisable(_compare_irq);
+                _blanking = false;
+                _compare = 0;
+                _dwell = GammaTable::full_dwell;
                 _timer.start();
             }
             _cb = cb;
@@ -65,23 +129,119 @@ public:
         }
     }
 
+    void set_period_scale(unsigned int scale) {
+        if (scale != _scale && _base_period) {
+            _scale = scale;
+            _next_period = _base_period * scale;
+            _timer.set_period(_next_period);
+            if (_blanking) update_compare();
+        }
+    }
+
+    void set_dwell(unsigned int dwell) {
+        if (!_base_period) return;
+        _dwell = dwell;
+        if (dwell >= GammaTable::full_dwell) {
+            if (_blanking) {
+                R_BSP_IrqDisable(_compare_irq);
+                _blanking = false;
+            }
+            return;
+        }
+        if (dwell == 0) {
+            DirectDrive::clear_matrix();
+            return;
+        }
+        update_compare();
+        if (!_blanking) {
+            R_BSP_IrqEnable(_compare_irq);
+            _blanking = true;
+        }
+    }
+
+    void set_stats(DriveStatsRecorder *rec) {
+        InterruptLock lock;
+        _stats = rec;
+    }
+
 protected:
+    ///compare register is buffered like the period, it takes effect with the next tick
+    void update_compare() {
+        uint32_t cmp = static_cast<uint32_t>((static_cast<uint64_t>(_next_period) * _dwell) >> 16);
+        if (cmp != _compare) {
+            _compare = cmp;
+            _timer.set_duty_cycle(cmp, CHANNEL_A);
+        }
+    }
+
     FspTimer _timer;
     TimerFunction _cb;
     unsigned int _freq = 0;
+    uint32_t _base_period = 0;
+    ///period of the next tick
+    uint32_t _next_period = 0;
+    ///period scale of the next tick and the running tick
+    unsigned int _scale = 1;
+    unsigned int _cur_scale = 1;
+    uint32_t _compare = 0;
+    unsigned int _dwell = GammaTable::full_dwell;
+    IRQn_Type _compare_irq = FSP_INVALID_VECTOR;
+    bool _blanking = false;
+    ///expected interval of the shortest tick in cycles
+    uint32_t _tick_cycles = 0;
+    DriveStatsRecorder *_stats = nullptr;
 };
 
 AutoDriveTimer *AutoDriveTimer::instance = nullptr;
 
 void enable_auto_drive(TimerFunction cb, unsigned int freq) {
+    static const bool pins_ok = DirectDrive::check_line_pins();
+    if (!pins_ok) return;
     if (AutoDriveTimer::instance == nullptr) AutoDriveTimer::instance = new AutoDriveTimer();
     AutoDriveTimer::instance->set_freq(freq, cb);
 }
 
+void set_auto_drive_period_scale(unsigned int scale) {
+    if (AutoDriveTimer::instance == nullptr) return;
+    AutoDriveTimer::instance->set_period_scale(scale);
+}
+
+void set_auto_drive_dwell(unsigned int dwell) {
+    if (AutoDriveTimer::instance == nullptr) return;
+    AutoDriveTimer::instance->set_dwell(dwell);
+}
+
+int schedule_task(TimerFunction fn, unsigned int delay, unsigned int period) {
+    InterruptLock lock;
+    return scheduler.schedule(fn, delay, period);
+}
+
+bool cancel_task(int id) {
+    InterruptLock lock;
+    return scheduler.cancel(id);
+}
+
+uint32_t read_cycle_counter() {
+    return DWT->CYCCNT;
+}
+
+uint32_t cycle_counter_freq() {
+    return SystemCoreClock;
+}
+
+void set_auto_drive_stats(DriveStatsRecorder *rec) {
+    if (rec) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    if (AutoDriveTimer::instance == nullptr) AutoDriveTimer::instance = new AutoDriveTimer();
+    AutoDriveTimer::instance->set_stats(rec);
+}
+
 void disable_auto_drive() {
     if (AutoDriveTimer::instance == nullptr) return;
     AutoDriveTimer::instance->set_freq(0, {});
 }
 
 }
-
+#endif
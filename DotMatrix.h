@@ -3,6 +3,8 @@
 #include <type_traits>
 #include <cstdint>
 #include <iterator>
+#include <array>
+#include <utility>
 namespace DotMatrix {
 
 ///Drive functions - to drive matrix directly
@@ -22,6 +24,74 @@ namespace DirectDrive {
      * @param row row number 0-10
      */
     void deactivate_row(int row);
+    ///write prepared state of all matrix lines
+    /**
+     * Writes PCNTR1 register of both ports in single store per port. Bits
+     * not belonging to the matrix are preserved.
+     *
+     * @param port0 value for R_PORT0->PCNTR1 (lower 16 bits - direction, upper 16 bits - output)
+     * @param port2 value for R_PORT2->PCNTR1 (lower 16 bits - direction, upper 16 bits - output)
+     */
+    void write_ports(uint32_t port0, uint32_t port2);
+
+    ///location of a matrix line on the MCU ports
+    struct LinePin {
+        ///port index (0 - PORT0, 1 - PORT2)
+        uint8_t port;
+        ///pin number on the port
+        uint8_t pin;
+    };
+
+    ///ports and pins of matrix lines 0-10 (must match g_pin_cfg[28..38], see check_line_pins())
+    constexpr LinePin line_pins[11] = {
+            {0, 3}, {0, 4}, {0, 11}, {0, 12}, {0, 13}, {0, 15},
+            {1, 4}, {1, 5}, {1, 6}, {1, 12}, {1, 13}
+    };
+
+    ///mask of matrix lines on the port (pin numbers)
+    /**
+     * @param port port index (0 - PORT0, 1 - PORT2)
+     */
+    constexpr uint32_t line_mask(unsigned int port) {
+        uint32_t m = 0;
+        for (const auto &lp: line_pins) {
+            if (lp.port == port) m |= static_cast<uint32_t>(1) << lp.pin;
+        }
+        return m;
+    }
+
+    ///verify line_pins against the pin table of the board
+    /**
+     * Port masks of the driver are compiled from line_pins. enable_auto_drive()
+     * calls this once and doesn't start the timer when it fails. Call it in setup()
+     * when you drive the matrix manually
+     *
+     * @retval true line_pins match g_pin_cfg[28..38] of the board variant
+     * @retval false the board assigns other pins to the matrix, don't drive it
+     */
+    bool check_line_pins();
+
+    ///count of LEDs
+    constexpr unsigned int num_leds = 96;
+    ///lines connected to each LED (source, sink). LED index is y*12+x in landscape orientation
+    constexpr uint8_t led_pins[num_leds][2] = {
+            { 7, 3 }, { 3, 7 }, { 7, 4 },
+            { 4, 7 }, { 3, 4 }, { 4, 3 }, { 7, 8 }, { 8, 7 }, { 3, 8 },
+            { 8, 3 }, { 4, 8 }, { 8, 4 }, { 7, 0 }, { 0, 7 }, { 3, 0 },
+            { 0, 3 }, { 4, 0 }, { 0, 4 }, { 8, 0 }, { 0, 8 }, { 7, 6 },
+            { 6, 7 }, { 3, 6 }, { 6, 3 }, { 4, 6 }, { 6, 4 }, { 8, 6 },
+            { 6, 8 }, { 0, 6 }, { 6, 0 }, { 7, 5 }, { 5, 7 }, { 3, 5 },
+            { 5, 3 }, { 4, 5 }, { 5, 4 }, { 8, 5 }, { 5, 8 }, { 0, 5 },
+            { 5, 0 }, { 6, 5 }, { 5, 6 }, { 7, 1 }, { 1, 7 }, { 3, 1 },
+            { 1, 3 }, { 4, 1 }, { 1, 4 }, { 8, 1 }, { 1, 8 }, { 0, 1 },
+            { 1, 0 }, { 6, 1 }, { 1, 6 }, { 5, 1 }, { 1, 5 }, { 7, 2 },
+            { 2, 7 }, { 3, 2 }, { 2, 3 }, { 4, 2 }, { 2, 4 }, { 8, 2 },
+            { 2, 8 }, { 0, 2 }, { 2, 0 }, { 6, 2 }, { 2, 6 }, { 5, 2 },
+            { 2, 5 }, { 1, 2 }, { 2, 1 }, { 7, 10 }, { 10, 7 }, { 3, 10 },
+            { 10,3 }, { 4, 10 }, { 10, 4 }, { 8, 10 }, { 10, 8 }, { 0, 10 },
+            { 10, 0 }, { 6, 10 }, { 10, 6 }, { 5, 10 }, { 10, 5 }, { 1, 10 },
+            { 10, 1 }, { 2, 10 }, { 10, 2 }, { 7, 9 }, { 9, 7 }, { 3, 9 },
+            { 9, 3 }, { 4, 9 }, { 9, 4 }, };
 
 }
 
@@ -32,6 +102,10 @@ enum class Format {
     monochrome_1bit,
     ///two bit format: 00-off, 01-low intensity, 10-high intensity, 11-blink high intensity
     gray_blink_2bit,
+    ///8 levels of intensity (0-7), binary code modulation. Pixel occupies 4 bits
+    gray_bcm_3bit,
+    ///16 levels of intensity (0-15), binary code modulation
+    gray_bcm_4bit,
 };
 
 enum class Order {
@@ -60,10 +134,11 @@ enum class Orientation {
  * @tparam _height height of the frame buffer
  * @tparam _format specified format (see Format)
  *
- * @note with of the frame buffer is limited to 170pixels, because total of
- * displayed area cannot exeed 256 bytes (12*170/8). If you want to implement
- * scrolling text, consider to use portrait orientation (8xunlimited) and place
- * 90 degree rotated letters
+ * @note with of the frame buffer is limited, because 12 rows of displayed
+ * area cannot exceed 256 bytes (12*width*bits_per_pixel < 2048 bits): 170 pixels
+ * for monochrome_1bit, 85 pixels for gray_blink_2bit, 42 pixels for BCM formats.
+ * If you want to implement scrolling text, consider to use portrait orientation
+ * (8xunlimited) and place 90 degree rotated letters
  *
  * @note zero pixel (0,0) is left top. X extends right, Y extends bottom
  */
@@ -81,10 +156,17 @@ struct FrameBuffer {
     ///bits per pixel
     static constexpr uint8_t bits_per_pixel =
             _format == Format::monochrome_1bit?1:
-            _format == Format::gray_blink_2bit?2:0;
+            _format == Format::gray_blink_2bit?2:
+            _format == Format::gray_bcm_3bit?4:
+            _format == Format::gray_bcm_4bit?4:0;
+    ///count of bit planes for binary code modulation (0 - not BCM format)
+    static constexpr uint8_t bcm_bits =
+            _format == Format::gray_bcm_3bit?3:
+            _format == Format::gray_bcm_4bit?4:0;
 
     ///recommended refresh rate
-    static constexpr unsigned int recommended_refresh_freq = 500 * bits_per_pixel;
+    /** For BCM formats, this is frequency of the shortest tick (bit plane 0) */
+    static constexpr unsigned int recommended_refresh_freq = bcm_bits?500 * ((1 << bcm_bits) - 1):500 * bits_per_pixel;
     ///total count of pixelx of frame buffer
     static constexpr unsigned int count_pixels = width*height;
     ///total active pixels in frame (because pixels at right still need to be counted)
@@ -92,13 +174,15 @@ struct FrameBuffer {
     ///count of bytes reserved for data
     static constexpr unsigned int count_bytes = (count_pixels*bits_per_pixel+7)/8;
     ///mask of pixel
-    static constexpr uint8_t mask = (1 << bits_per_pixel) - 1;
+    static constexpr uint8_t mask = (1 << (bcm_bits?bcm_bits:bits_per_pixel)) - 1;
+    ///xor applied to byte address by the driver (nonzero for views of words, see LedMatrixFrame)
+    static constexpr unsigned int byte_swizzle = 0;
 
 
     static_assert(bits_per_pixel > 0, "Unsupported format");
     static_assert(width > 0, "Width can't be zero");
     static_assert(height > 0, "Height can't be zero");
-    static_assert(whole_frame<2048, "Too large frame");
+    static_assert(whole_frame*bits_per_pixel<2048, "Too large frame");
 
 
     ///actual buffer - it is public, you can directly access
@@ -143,10 +227,7 @@ struct FrameBuffer {
      * @param value specifies color.
      */
     constexpr void clear(uint8_t value = 0) {
-        uint8_t byte = 0;
-        for (int i = 0; i < 8; i+=bits_per_pixel) {
-            byte |= (value & mask) << i;
-        }
+        uint8_t byte = fill_byte(value);
         std::fill(std::begin(pixels), std::end(pixels), byte);
     }
 
@@ -166,6 +247,12 @@ struct FrameBuffer {
         int sy = (y0 < y1) ? 1 : -1;
         int err = dx - dy;
 
+        if (dx == 0 || dy == 0) {
+            //axis-aligned line is box
+            draw_box(x0, y0, x1, y1, color);
+            return;
+        }
+
         while (true) {
             set_pixel(static_cast<unsigned int>(x0), static_cast<unsigned int>(y0), color);
             if (x0 == x1 && y0 == y1) break;
@@ -194,13 +281,61 @@ struct FrameBuffer {
     constexpr void draw_box(int x0, int y0, int x1, int y1, uint8_t color) {
         if (y0 > y1) std::swap(y0,y1);
         if (x0 > x1) std::swap(x0,x1);
-        for (int y = y0; y <= y1; ++y) {
-            for (int x = x0; x <= x1; ++x) {
-                set_pixel(static_cast<unsigned int>(x),static_cast<unsigned int>(y), color);
+        if (x1 < 0 || y1 < 0 || x0 >= static_cast<int>(width) || y0 >= static_cast<int>(height)) return;
+        unsigned int cx0 = std::max(x0, 0);
+        unsigned int cy0 = std::max(y0, 0);
+        unsigned int cx1 = std::min<unsigned int>(x1, width - 1);
+        unsigned int cy1 = std::min<unsigned int>(y1, height - 1);
+        if (cx0 == 0 && cx1 == width - 1) {
+            //full rows are continuous
+            fill_bits(cy0 * width * bits_per_pixel, (cy1 + 1) * width * bits_per_pixel, color);
+        } else {
+            for (unsigned int y = cy0; y <= cy1; ++y) {
+                fill_bits((y * width + cx0) * bits_per_pixel, (y * width + cx1 + 1) * bits_per_pixel, color);
             }
         }
     }
 
+protected:
+
+    ///repeat pixel value in whole byte
+    static constexpr uint8_t fill_byte(uint8_t value) {
+        uint8_t byte = 0;
+        for (int i = 0; i < 8; i+=bits_per_pixel) {
+            byte |= (value & mask) << i;
+        }
+        return byte;
+    }
+
+    ///fill range of bits by color
+    /**
+     * Partial bytes at both ends are masked, whole bytes between are
+     * stored. Pixel layout doesn't depend on Order, so it works for both orders
+     *
+     * @param bit0 first bit (pixel index * bits_per_pixel)
+     * @param bit1 end bit (not included)
+     * @param color color
+     */
+    constexpr void fill_bits(unsigned int bit0, unsigned int bit1, uint8_t color) {
+        uint8_t byte = fill_byte(color);
+        unsigned int b0 = bit0 / 8;
+        unsigned int b1 = bit1 / 8;
+        uint8_t head = static_cast<uint8_t>(0xFF << (bit0 % 8));
+        uint8_t tail = static_cast<uint8_t>((1 << (bit1 % 8)) - 1);
+        if (b0 == b1) {
+            uint8_t m = head & tail;
+            pixels[b0] = static_cast<uint8_t>((pixels[b0] & ~m) | (byte & m));
+            return;
+        }
+        pixels[b0] = static_cast<uint8_t>((pixels[b0] & ~head) | (byte & head));
+        for (unsigned int i = b0 + 1; i < b1; ++i) {
+            pixels[i] = byte;
+        }
+        if (tail) {
+            pixels[b1] = static_cast<uint8_t>((pixels[b1] & ~tail) | (byte & tail));
+        }
+    }
+
 };
 
 ///contains driver's state
@@ -216,8 +351,141 @@ struct State {
     ///specifies mask of counter for flashing
     /** If counter & blink_mask is  non zero, blinking pixels are shown otherwise not */
     unsigned int blink_mask = 512;
+    ///global brightness (0 - off, 255 - full)
+    /** Applied by auto drive, see Driver::adjust_auto_drive() */
+    uint8_t brightness = 255;
+};
+
+///Table of dwell time for every brightness level
+/**
+ * Dwell is part of the tick when the row is lit, in 1/65536 of the tick.
+ * Levels follow CIE 1931 lightness, so steps of brightness look even.
+ */
+struct GammaTable {
+    ///dwell value meaning no blanking
+    static constexpr uint16_t full_dwell = 0xFFFF;
+    ///dwell for brightness 0-255
+    uint16_t dwell[256] = {};
+
+    constexpr GammaTable() {
+        for (unsigned int i = 0; i < 256; ++i) {
+            //L* = i * 100 / 255
+            double l = i * 100.0 / 255.0;
+            double y = l <= 8.0?l / 903.3:((l + 16.0) / 116.0) * ((l + 16.0) / 116.0) * ((l + 16.0) / 116.0);
+            dwell[i] = static_cast<uint16_t>(y * full_dwell + 0.5);
+        }
+    }
+};
+
+///gamma table used by the driver
+constexpr GammaTable gamma_table = {};
+
+///Change period of auto drive timer
+/**
+ * Used by binary code modulation, called from the auto drive callback. The timer
+ * period register is buffered, so the new period applies to the next tick
+ *
+ * @param scale multiple of period set by enable_auto_drive()
+ */
+void set_auto_drive_period_scale(unsigned int scale);
+
+///Blank the matrix after part of the tick
+/**
+ * Used by global brightness, called from the auto drive callback. It uses
+ * compare match of the auto drive timer, so it adds at most one interrupt
+ * per tick. The dwell is measured from the beginning of the tick. The compare
+ * register is buffered, so the dwell takes effect from the next tick and it is
+ * scaled by the period of that tick (see set_auto_drive_period_scale())
+ *
+ * @param dwell part of the tick when the row is lit in 1/65536 of the tick.
+ * GammaTable::full_dwell disables blanking, 0 blanks immediately
+ */
+void set_auto_drive_dwell(unsigned int dwell);
+
+///How a layer is combined with layers below
+enum class LayerOp : uint8_t {
+    ///layer replaces pixels below (where mask is non zero, if mask is set)
+    overwrite,
+    ///bitwise or of pixel values
+    or_op,
+    ///bitwise and of pixel values
+    and_op,
+    ///bitwise xor of pixel values
+    xor_op,
 };
 
+///Fixed stack of layers combined by the driver, see layers.h
+template<typename FrameBuffer, unsigned int N>
+struct LayerStack;
+
+
+///LED maps of the driver, built by the compiler
+/**
+ * @tparam FrameBuffer type of frame buffer
+ * @tparam _orientation orientation
+ * @tparam _offset pixel offset in frame buffer
+ */
+template<typename FrameBuffer, Orientation _orientation, int _offset>
+struct DriverMap {
+    struct PixelLocation {
+        uint8_t offset = 0;
+        uint8_t shift = 0;
+        ///bit of sink line in combined direction mask (0-15 PORT0, 16-31 PORT2)
+        uint8_t sink = 0;
+    };
+    ///PCNTR1 values to drive the row high (source) while others are in high impedance
+    struct RowSource {
+        uint32_t port0 = 0;
+        uint32_t port2 = 0;
+    };
+    static constexpr unsigned int num_rows = 11;
+    PixelLocation pixel_map[num_rows][num_rows-1] = {};
+    RowSource row_source[num_rows] = {};
+    ///sink of unused pixel locations (the source itself, which has no effect)
+    uint8_t source_sink[num_rows] = {};
+
+    constexpr DriverMap() {
+        constexpr unsigned int bits_per_pixel = FrameBuffer::bits_per_pixel;
+        constexpr unsigned int fb_width = FrameBuffer::width;
+        for (unsigned int row = 0; row < num_rows; ++row) {
+            const auto &lp = DirectDrive::line_pins[row];
+            uint32_t v = (static_cast<uint32_t>(1) << lp.pin) | (static_cast<uint32_t>(1) << (lp.pin + 16));
+            if (lp.port) row_source[row].port2 = v;
+            else row_source[row].port0 = v;
+            source_sink[row] = lp.pin + lp.port * 16;
+            for (auto &l: pixel_map[row]) l.sink = source_sink[row];
+        }
+        unsigned int px = 0;
+        for (const auto &p: DirectDrive::led_pins) {
+            auto row = p[0];
+            auto col = p[1];
+            const auto &sink = DirectDrive::line_pins[col];
+            if (col > row) --col;
+            PixelLocation &l = pixel_map[row][col];
+            l.sink = sink.pin + sink.port * 16;
+            unsigned int x = px % 12;
+            unsigned int y = px / 12;
+            unsigned int pxofs = 0;
+            if constexpr(_orientation == Orientation::landscape) {
+                pxofs = y * fb_width + x + _offset;
+            } else if constexpr(_orientation == Orientation::portrait) {
+                pxofs = (7-y)  + x * fb_width + _offset;
+            } else if constexpr(_orientation == Orientation::reverse_landscape) {
+                pxofs = (7-y) * fb_width + (11-x) + _offset;
+            } else if constexpr(_orientation == Orientation::reverse_portrait) {
+                pxofs = y + (11-x) * fb_width + _offset;
+            }
+            pxofs *= bits_per_pixel;
+            l.offset = pxofs / 8;
+            if (FrameBuffer::order == Order::lsb_to_msb) {
+                l.shift = (8-bits_per_pixel)-pxofs % 8;
+            } else {
+                l.shift = pxofs % 8;
+            }
+            ++px;
+        }
+    }
+};
 
 ///Declaration of the driver
 /**
@@ -227,10 +495,8 @@ struct State {
  * @tparam FrameBuffer type of frame buffer
  * @tparam _orientation specifies orientation.
  * @tparam _offset pixel offset in frame buffer. While working with virtual screen, you
- * can set begin of the frame buffer in step of whole byte. Which means you cannot
- * slide left and right by pixel. For monochrome, you can slide by 8 pixels. However you
- * can create 8 drivers, each driver is shifted by 1 pixel right. To sliding left and
- * right, you will need to choose appropriate driver for current sliding position.
+ * can set begin of the frame buffer in step of whole byte (fb_offset) and in step of
+ * pixel (px_offset), see drive(). So one driver can slide left and right by single pixel
  *
  * @note if you want to implement scrolling text, consider portrait orientation and
  * text rotated about 90 degrees. You can freely slide up and down with one driver
@@ -238,10 +504,10 @@ struct State {
 template<typename FrameBuffer, Orientation _orientation = Orientation::portrait, int _offset = 0>
 class Driver {
 public:
-    ///construct driver and build LED maps
-    /** Please, use constexpr declaration which results by preparing maps by a compiler*/
+    ///construct driver
+    /** LED maps are static and they are built by the compiler (see DriverMap) */
 
-    constexpr Driver() {build_map();}
+    constexpr Driver() {}
 
     ///Drive the LED matrix a display something
     /**
@@ -253,116 +519,226 @@ public:
      * @param st state of driving
      * @param fb frame buffer to display
      * @param fb_offset offset in frame buffer in bytes
+     * @param px_offset additional offset in frame buffer in pixels. In landscape
+     * orientation this slides the display window right by pixels
      */
-    void drive(State &st, const FrameBuffer &fb, unsigned int fb_offset = 0) const {
+    void drive(State &st, const FrameBuffer &fb, unsigned int fb_offset = 0, unsigned int px_offset = 0) const {
         auto c = ++st.counter;
-        if constexpr(FrameBuffer::format == Format::monochrome_1bit) {
-            drive_mono(c, fb, fb_offset);
-        } else if constexpr(FrameBuffer::format == Format::gray_blink_2bit) {
-            drive_gray(c, !(c & st.blink_mask), fb, fb_offset);
+        unsigned int bit_offset = px_offset * bits_per_pixel;
+        fb_offset += bit_offset / 8;
+        bit_offset %= 8;
+        RowPhase ph = row_phase(st, c);
+        if (bit_offset) {
+            drive_row(ph, [&](const PixelLocation &ploc) {
+                return load_pixel(fb, ploc, fb_offset, bit_offset);
+            });
+        } else if (fb_offset == 0) {
+            //jump table of unrolled rows, addresses are immediates
+            static constexpr auto rows = make_row_table<false>(std::make_index_sequence<num_rows>());
+            commit_row(ph.hrow, rows[ph.hrow](fb.pixels, 0, ph.sel));
+        } else {
+            static constexpr auto rows = make_row_table<true>(std::make_index_sequence<num_rows>());
+            commit_row(ph.hrow, rows[ph.hrow](fb.pixels, fb_offset % FrameBuffer::count_bytes, ph.sel));
         }
     }
+
+    ///Drive the LED matrix and display combined layers
+    /**
+     * Pixels of all layers are combined from bottom to top by their LayerOp
+     *
+     * @param st state of driving
+     * @param layers layer stack, see LayerStack
+     */
+    template<unsigned int N>
+    void drive(State &st, const LayerStack<FrameBuffer, N> &layers) const {
+        auto c = ++st.counter;
+        unsigned int offsets[N] = {};
+        unsigned int bit_offsets[N] = {};
+        for (unsigned int i = 0; i < N; ++i) {
+            const auto &l = layers.layers[i];
+            unsigned int bit_offset = l.px_offset * bits_per_pixel;
+            offsets[i] = l.fb_offset + bit_offset / 8;
+            bit_offsets[i] = bit_offset % 8;
+        }
+        drive_row(row_phase(st, c), [&](const PixelLocation &ploc) {
+            uint8_t v = 0;
+            for (unsigned int i = 0; i < N; ++i) {
+                const auto &l = layers.layers[i];
+                if (l.pixels == nullptr) continue;
+                uint8_t lv = load_pixel(l.pixels, l.count_bytes, ploc, offsets[i], bit_offsets[i]);
+                if (i == 0) {
+                    v = lv;
+                    continue;
+                }
+                switch (l.op) {
+                    case LayerOp::or_op: v |= lv; break;
+                    case LayerOp::and_op: v &= lv; break;
+                    case LayerOp::xor_op: v ^= lv; break;
+                    default:
+                        if (l.mask == nullptr || load_pixel(l.mask, l.count_bytes, ploc, offsets[i], bit_offsets[i])) {
+                            v = lv;
+                        }
+                        break;
+                }
+            }
+            return v;
+        });
+    }
+
+    ///count of ticks to display one row
+    static constexpr unsigned int ticks_per_row =
+            FrameBuffer::bcm_bits?FrameBuffer::bcm_bits:FrameBuffer::bits_per_pixel;
+
+    ///retrieve duration of the tick in multiples of the shortest tick
+    /**
+     * @param counter value of the counter of the tick (State::counter after drive())
+     * @return relative duration. It is always 1 except BCM formats, where
+     * bit plane N is displayed for 2^N
+     */
+    static constexpr unsigned int tick_weight(unsigned int counter) {
+        if constexpr(FrameBuffer::bcm_bits != 0) {
+            return 1U << (counter % FrameBuffer::bcm_bits);
+        } else {
+            return 1;
+        }
+    }
+
+    ///adjust auto drive timer for the next tick
+    /**
+     * Call from the auto drive callback after drive(). It applies
+     * State::brightness and for BCM formats, it sets period of the next tick
+     *
+     * @param st state of driving
+     */
+    static void adjust_auto_drive(const State &st) {
+        set_auto_drive_dwell(gamma_table.dwell[st.brightness]);
+        if constexpr(FrameBuffer::bcm_bits != 0) {
+            set_auto_drive_period_scale(tick_weight(st.counter + 1));
+        }
+    }
+
+    ///determine whether the last drive() finished the scan of whole matrix
+    /**
+     * @param st state of driving
+     * @retval true last call displayed the row 10 (in all phases), next call starts new scan
+     * @retval false scan is in progress
+     */
+    static constexpr bool scan_complete(const State &st) {
+        return st.counter % (ticks_per_row * num_rows) == ticks_per_row * num_rows - 1;
+    }
 protected:
-    struct PixelLocation {
-        uint8_t offset;
-        uint8_t shift = 8;
-    };
+    using Map = DriverMap<FrameBuffer, _orientation, _offset>;
+    using PixelLocation = typename Map::PixelLocation;
+    using RowSource = typename Map::RowSource;
     static constexpr Order order = FrameBuffer::order;
     static constexpr unsigned int bits_per_pixel = FrameBuffer::bits_per_pixel;
-    static constexpr unsigned int fb_width = FrameBuffer::width;
     static constexpr uint8_t mask = FrameBuffer::mask;
-    static constexpr unsigned int num_leds = 96;
-    static constexpr unsigned int num_rows = 11;
-    static constexpr uint8_t pins[num_leds][2] = {
-            { 7, 3 }, { 3, 7 }, { 7, 4 },
-            { 4, 7 }, { 3, 4 }, { 4, 3 }, { 7, 8 }, { 8, 7 }, { 3, 8 },
-            { 8, 3 }, { 4, 8 }, { 8, 4 }, { 7, 0 }, { 0, 7 }, { 3, 0 },
-            { 0, 3 }, { 4, 0 }, { 0, 4 }, { 8, 0 }, { 0, 8 }, { 7, 6 },
-            { 6, 7 }, { 3, 6 }, { 6, 3 }, { 4, 6 }, { 6, 4 }, { 8, 6 },
-            { 6, 8 }, { 0, 6 }, { 6, 0 }, { 7, 5 }, { 5, 7 }, { 3, 5 },
-            { 5, 3 }, { 4, 5 }, { 5, 4 }, { 8, 5 }, { 5, 8 }, { 0, 5 },
-            { 5, 0 }, { 6, 5 }, { 5, 6 }, { 7, 1 }, { 1, 7 }, { 3, 1 },
-            { 1, 3 }, { 4, 1 }, { 1, 4 }, { 8, 1 }, { 1, 8 }, { 0, 1 },
-            { 1, 0 }, { 6, 1 }, { 1, 6 }, { 5, 1 }, { 1, 5 }, { 7, 2 },
-            { 2, 7 }, { 3, 2 }, { 2, 3 }, { 4, 2 }, { 2, 4 }, { 8, 2 },
-            { 2, 8 }, { 0, 2 }, { 2, 0 }, { 6, 2 }, { 2, 6 }, { 5, 2 },
-            { 2, 5 }, { 1, 2 }, { 2, 1 }, { 7, 10 }, { 10, 7 }, { 3, 10 },
-            { 10,3 }, { 4, 10 }, { 10, 4 }, { 8, 10 }, { 10, 8 }, { 0, 10 },
-            { 10, 0 }, { 6, 10 }, { 10, 6 }, { 5, 10 }, { 10, 5 }, { 1, 10 },
-            { 10, 1 }, { 2, 10 }, { 10, 2 }, { 7, 9 }, { 9, 7 }, { 3, 9 },
-            { 9, 3 }, { 4, 9 }, { 9, 4 }, };
-    PixelLocation pixel_map[num_rows][num_rows-1] = {};
-    constexpr void build_map() {
-        unsigned int px = 0;
-        for (const auto &p: pins) {
-            auto row = p[0];
-            auto col = p[1];
-            if (col > row) --col;
-            PixelLocation &l = pixel_map[row][col];
-            unsigned int x = px % 12;
-            unsigned int y = px / 12;
-            unsigned int pxofs = 0;
-            if constexpr(_orientation == Orientation::landscape) {
-                pxofs = y * fb_width + x + _offset;
-            } else if constexpr(_orientation == Orientation::portrait) {
-                pxofs = (7-y)  + x * fb_width + _offset;
-            } else if constexpr(_orientation == Orientation::reverse_landscape) {
-                pxofs = (7-y) * fb_width + (11-x) + _offset;
-            } else if constexpr(_orientation == Orientation::reverse_portrait) {
-                pxofs = y * fb_width + (11-x) * fb_width + _offset;
-            }
-            pxofs *= bits_per_pixel;
-            l.offset = pxofs / 8;
-            if (order == Order::lsb_to_msb) {
-                l.shift = (8-bits_per_pixel)-pxofs % 8;
+    static constexpr unsigned int num_leds = DirectDrive::num_leds;
+    static constexpr unsigned int num_rows = Map::num_rows;
+    static constexpr Map map = {};
+
+    ///row displayed in the tick and selector of lit pixel values
+    struct RowPhase {
+        unsigned int hrow;
+        ///bit N is set, when pixel value N is lit in this tick
+        uint32_t sel;
+    };
+    static constexpr uint32_t bcm_select(unsigned int plane) {
+        uint32_t sel = 0;
+        for (unsigned int v = 0; v < 16; ++v) sel |= ((v >> plane) & 1) << v;
+        return sel;
+    }
+    static constexpr RowPhase row_phase(const State &st, unsigned int c) {
+        if constexpr(FrameBuffer::format == Format::monochrome_1bit) {
+            return {c % num_rows, 0x2};
+        } else if constexpr(FrameBuffer::format == Format::gray_blink_2bit) {
+            bool gray_on = !(c & 1);
+            bool flash = !(c & st.blink_mask);
+            return {(c >> 1) % num_rows, 0x4U | (gray_on?0x2U:0U) | (flash?0x8U:0U)};
+        } else {
+            constexpr uint32_t planes[4] = {bcm_select(0), bcm_select(1), bcm_select(2), bcm_select(3)};
+            return {(c / FrameBuffer::bcm_bits) % num_rows, planes[c % FrameBuffer::bcm_bits]};
+        }
+    }
+    static constexpr uint32_t pixel_bit(uint32_t b, uint32_t sel) {
+        if constexpr(FrameBuffer::format == Format::monochrome_1bit) {
+            return b;
+        } else {
+            return (sel >> b) & 1;
+        }
+    }
+    void commit_row(unsigned int hrow, uint32_t sinks) const {
+        const RowSource &src = map.row_source[hrow];
+        DirectDrive::write_ports(src.port0 | (sinks & 0xFFFF), src.port2 | (sinks >> 16));
+    }
+    static uint8_t load_pixel(const FrameBuffer &fb, const PixelLocation &ploc,
+                              unsigned int fb_offset, unsigned int bit_offset) {
+        return load_pixel(fb.pixels, FrameBuffer::count_bytes, ploc, fb_offset, bit_offset);
+    }
+    static uint8_t load_pixel(const uint8_t *pixels, unsigned int count_bytes, const PixelLocation &ploc,
+                              unsigned int fb_offset, unsigned int bit_offset) {
+        unsigned int addr = fb_offset + ploc.offset;
+        unsigned int shift = ploc.shift;
+        if (bit_offset) {
+            unsigned int pos = bit_offset;
+            if constexpr(order == Order::lsb_to_msb) {
+                pos += (8 - bits_per_pixel) - shift;
+                shift = (8 - bits_per_pixel) - (pos & 7);
             } else {
-                l.shift = pxofs % 8;
+                pos += shift;
+                shift = pos & 7;
             }
-            ++px;
+            addr += pos >> 3;
         }
+        return (pixels[(addr % count_bytes) ^ FrameBuffer::byte_swizzle] >> shift) & mask;
     }
-    void drive_mono(unsigned int c, const FrameBuffer &fb, unsigned int fb_offset) const {
-        DirectDrive::clear_matrix();
-        unsigned int hrow = c % num_rows;
-        DirectDrive::activate_row(hrow, true);
+    template<typename Load>
+    void drive_row(const RowPhase &ph, Load &&load) const {
+        uint32_t sinks = 0;
         for (unsigned int i = 0; i < num_rows-1; ++i) {
-            const PixelLocation &ploc = pixel_map[hrow][i];
-            auto lrow = i>=hrow?i+1:i;
-            unsigned int addr = (fb_offset + ploc.offset) % FrameBuffer::count_bytes;
-            uint8_t b = (fb.pixels[addr] >> ploc.shift) & 1;
-            if (b) DirectDrive::activate_row(lrow, false);
+            const PixelLocation &ploc = map.pixel_map[ph.hrow][i];
+            sinks |= pixel_bit(load(ploc), ph.sel) << ploc.sink;
         }
+        commit_row(ph.hrow, sinks);
     }
-    void drive_gray(unsigned int c, bool flash, const FrameBuffer &fb, unsigned int fb_offset) const {
-        bool gray_on = !(c & 1);;
-        unsigned int hrow = (c >> 1) % num_rows;
-        if (gray_on) {
-            DirectDrive::clear_matrix();
-            DirectDrive::activate_row(hrow, true);
-            for (unsigned int i = 0; i < num_rows-1; ++i) {
-                const PixelLocation &ploc = pixel_map[hrow][i];
-                auto lrow = i>=hrow?i+1:i;
-                unsigned int addr = (fb_offset + ploc.offset) % FrameBuffer::count_bytes;
-                uint8_t b = (fb.pixels[addr] >> ploc.shift) & 3;
-                switch (b) {
-                    default:break;
-                    case 1: [[fallthrough]];
-                    case 2: DirectDrive::activate_row(lrow, false);break;
-                    case 3: if (flash) DirectDrive::activate_row(lrow, false);break;;
-                }
-            }
+
+    ///one pixel of unrolled row
+    /**
+     * @tparam hrow row
+     * @tparam i index of pixel location
+     * @tparam with_offset fb_offset is used (it must be less than count_bytes)
+     */
+    template<unsigned int hrow, unsigned int i, bool with_offset>
+    static uint32_t row_pixel(const uint8_t *pixels, unsigned int fb_offset, uint32_t sel) {
+        constexpr PixelLocation ploc = map.pixel_map[hrow][i];
+        if constexpr(ploc.sink == map.source_sink[hrow]) {
+            return 0;
         } else {
-            for (int i = 0; i < num_rows-1; ++i) {
-                const PixelLocation &ploc = pixel_map[hrow][i];
-                auto lrow = i>=hrow?i+1:i;
-                unsigned int addr = (fb_offset + ploc.offset) % FrameBuffer::count_bytes;
-                uint8_t b = (fb.pixels[addr] >> ploc.shift) & 3;
-                if (b == 1) {
-                    DirectDrive::deactivate_row(lrow);
-                }
+            constexpr unsigned int count_bytes = FrameBuffer::count_bytes;
+            constexpr unsigned int offset = ploc.offset % count_bytes;
+            unsigned int addr = offset;
+            if constexpr(with_offset) {
+                addr += fb_offset;
+                if (addr >= count_bytes) addr -= count_bytes;
             }
+            uint32_t b = (pixels[addr ^ FrameBuffer::byte_swizzle] >> ploc.shift) & mask;
+            return pixel_bit(b, sel) << ploc.sink;
         }
     }
+    template<unsigned int hrow, bool with_offset, std::size_t... I>
+    static uint32_t row_sinks(const uint8_t *pixels, unsigned int fb_offset, uint32_t sel, std::index_sequence<I...>) {
+        return (row_pixel<hrow, I, with_offset>(pixels, fb_offset, sel) | ... | 0U);
+    }
+    ///unrolled row, returns sinks
+    template<unsigned int hrow, bool with_offset>
+    static uint32_t drive_unrolled(const uint8_t *pixels, unsigned int fb_offset, uint32_t sel) {
+        return row_sinks<hrow, with_offset>(pixels, fb_offset, sel, std::make_index_sequence<num_rows-1>());
+    }
+    using RowFn = uint32_t (*)(const uint8_t *, unsigned int, uint32_t);
+    template<bool with_offset, std::size_t... R>
+    static constexpr std::array<RowFn, num_rows> make_row_table(std::index_sequence<R...>) {
+        return {&drive_unrolled<R, with_offset>...};
+    }
 };
 
 
@@ -426,7 +802,10 @@ protected:
  *  arguments. Keep this function shortest as possible. The function can have
  *  a closure (lambda function), however it is limited and must be trivially copy
  *  constructible (we don't use std::function here)
- * @param freq frequency in Hz. 1bit framebuffer needs 500Hz, 2bit framebuffer needs 1000Hz
+ * @param freq frequency in Hz. 1bit framebuffer needs 500Hz, 2bit framebuffer needs 1000Hz. BCM
+ * formats needs recommended_refresh_freq, period is changed by set_auto_drive_period_scale()
+ *
+ * @note auto drive is not enabled when DirectDrive::check_line_pins() fails
  */
 void enable_auto_drive(TimerFunction cb, unsigned int freq);
 
@@ -441,7 +820,10 @@ template<typename FrameBuffer, Orientation _orientation, int _offset>
 void enable_auto_drive(const Driver<FrameBuffer, _orientation, _offset> &driver,
          State &st, const FrameBuffer &fb) {
 
-    enable_auto_drive([&driver, &fb, &st]{driver.drive(st, fb);}, FrameBuffer::recommended_refresh_freq);
+    enable_auto_drive([&driver, &fb, &st]{
+        driver.drive(st, fb);
+        driver.adjust_auto_drive(st);
+    }, FrameBuffer::recommended_refresh_freq);
 }
 
 ///Enables automatic driving (using timer and interrupt) with scrolling
@@ -466,13 +848,73 @@ void enable_auto_drive_scroll(const Driver<FrameBuffer, _orientation, _offset> &
     speed_div = std::max<unsigned int>(1, speed_div);
     enable_auto_drive([&driver, &st, &fb, speed_div]{
         driver.drive(st, fb, (st.counter/speed_div)*step);
+        driver.adjust_auto_drive(st);
     }, FrameBuffer::recommended_refresh_freq);
 }
 
 void disable_auto_drive();
 
+///capacity of the scheduler of the auto drive timer
+constexpr unsigned int auto_drive_scheduler_capacity = 8;
+
+///Schedule a task on the auto drive timer
+/**
+ * The task is called from the auto drive interrupt after the driver, so keep it
+ * short. Time is counted in ticks of the auto drive (frequency passed to
+ * enable_auto_drive(), for BCM formats the shortest tick, longer ticks count
+ * by their weight). Tasks run only while auto drive is enabled. Can be called
+ * from loop() and from a task, the interrupt state of the caller is preserved.
+ *
+ * @param fn function to call (same restrictions as enable_auto_drive())
+ * @param delay ticks to the first call
+ * @param period period in ticks, 0 - one-shot task
+ * @return id of task, or -1 if there is no free slot (see auto_drive_scheduler_capacity)
+ */
+int schedule_task(TimerFunction fn, unsigned int delay, unsigned int period = 0);
+
+///Cancel a scheduled task
+/**
+ * Can be called from loop() and from a task (also the task being run)
+ *
+ * @param id id returned by schedule_task()
+ * @retval true canceled
+ * @retval false not found
+ */
+bool cancel_task(int id);
+
+///Read free running cycle counter
+/**
+ * DWT->CYCCNT on the target (enabled by set_auto_drive_stats()), nanoseconds
+ * of steady clock in the simulator
+ */
+uint32_t read_cycle_counter();
+
+///Retrieve frequency of read_cycle_counter() in Hz
+uint32_t cycle_counter_freq();
+
+class DriveStatsRecorder;
+
+///Record timing of the auto drive interrupt
+/**
+ * Every tick measures the callback and scheduled tasks, interval since the previous
+ * tick and missed ticks. Costs two reads of the cycle counter per tick.
+ *
+ * @param rec recorder, read it by DriveStatsRecorder::snapshot(). nullptr - stop recording
+ */
+void set_auto_drive_stats(DriveStatsRecorder *rec);
+
 
 }
+#include "scheduler.h"
+#include "instrument.h"
+#include "tracked.h"
+#include "layers.h"
 #include "bitmap.h"
 #include "font_6p.h"
 #include "font_5x3.h"
+#include "textlayout.h"
+#include "swapchain.h"
+#include "framequeue.h"
+#include "animation.h"
+#include "ledmatrixframe.h"
+#include "marquee.h"
@@ -0,0 +1,195 @@
+#ifndef ARDUINO
+#include "DotMatrixSim.h"
+#include <chrono>
+
+namespace DotMatrix {
+
+namespace {
+
+struct SimState {
+    ///simulated PCNTR1 of PORT0 and PORT2
+    uint32_t pcntr1[2] = {};
+    TimerFunction cb;
+    unsigned int freq = 0;
+    ///period scale of the current and the next tick
+    unsigned int scale = 1;
+    unsigned int next_scale = 1;
+    ///period scale of the previous tick
+    unsigned int prev_scale = 1;
+    ///dwell of the current tick
+    unsigned int dwell = GammaTable::full_dwell;
+    std::bitset<DirectDrive::num_leds> last;
+    Simulator::Stats stats;
+    DriveStatsRecorder *stats_rec = nullptr;
+    ///simulated interval since the previous tick in ns (0 - first tick)
+    uint32_t prev_interval = 0;
+};
+
+SimState sim;
+TickScheduler<auto_drive_scheduler_capacity> scheduler;
+
+constexpr uint32_t port_mask(unsigned int port) {
+    return DirectDrive::line_mask(port) | (DirectDrive::line_mask(port) << 16);
+}
+
+}
+
+namespace DirectDrive {
+
+void clear_matrix() {
+    sim.pcntr1[0] &= ~line_mask(0);
+    sim.pcntr1[1] &= ~line_mask(1);
+}
+void activate_row(int row, bool high) {
+    const LinePin &lp = line_pins[row];
+    uint32_t &r = sim.pcntr1[lp.port];
+    r |= static_cast<uint32_t>(1) << lp.pin;
+    if (high) r |= static_cast<uint32_t>(1) << (lp.pin + 16);
+    else r &= ~(static_cast<uint32_t>(1) << (lp.pin + 16));
+}
+void deactivate_row(int row) {
+    const LinePin &lp = line_pins[row];
+    sim.pcntr1[lp.port] &= ~(static_cast<uint32_t>(1) << lp.pin);
+}
+void write_ports(uint32_t port0, uint32_t port2) {
+    sim.pcntr1[0] = (sim.pcntr1[0] & ~port_mask(0)) | port0;
+    sim.pcntr1[1] = (sim.pcntr1[1] & ~port_mask(1)) | port2;
+}
+bool check_line_pins() {
+    //the simulator models line_pins
+    return true;
+}
+
+}
+
+namespace Simulator {
+
+Line line_state(unsigned int line) {
+    const DirectDrive::LinePin &lp = DirectDrive::line_pins[line];
+    uint32_t r = sim.pcntr1[lp.port];
+    if (!((r >> lp.pin) & 1)) return Line::high_z;
+    return ((r >> (lp.pin + 16)) & 1)?Line::high:Line::low;
+}
+
+bool is_lit(unsigned int led) {
+    const auto &p = DirectDrive::led_pins[led];
+    return line_state(p[0]) == Line::high && line_state(p[1]) == Line::low;
+}
+
+static void sample(unsigned long long duration, bool update_last) {
+    Line lines[11];
+    for (unsigned int i = 0; i < 11; ++i) lines[i] = line_state(i);
+    for (unsigned int i = 0; i < DirectDrive::num_leds; ++i) {
+        const auto &p = DirectDrive::led_pins[i];
+        bool lit = lines[p[0]] == Line::high && lines[p[1]] == Line::low;
+        if (update_last) sim.last[i] = lit;
+        if (lit) sim.stats.on_time[i] += duration;
+    }
+    sim.stats.time += duration;
+}
+
+void tick(unsigned int weight) {
+    sample(weight * Stats::time_unit, true);
+    ++sim.stats.ticks;
+    ++sim.stats.interrupts;
+}
+
+unsigned int run_auto_drive(unsigned int ticks) {
+    if (!sim.cb || !sim.freq) return 0;
+    for (unsigned int i = 0; i < ticks; ++i) {
+        uint32_t start = read_cycle_counter();
+        sim.cb();
+        scheduler.advance(sim.scale);
+        if (sim.stats_rec) {
+            //interrupts come exactly in simulated time, the interval since the previous
+            //tick is its period and it is expected by the period of the tick which ended
+            uint32_t expected = static_cast<uint32_t>(1000000000ULL * sim.prev_scale / sim.freq);
+            sim.stats_rec->record(read_cycle_counter() - start, sim.prev_interval, expected);
+            sim.prev_interval = static_cast<uint32_t>(1000000000ULL * sim.scale / sim.freq);
+        }
+        unsigned long long duration = sim.scale * Stats::time_unit;
+        if (sim.dwell != 0 && sim.dwell < GammaTable::full_dwell) {
+            //compare match interrupt blanks the matrix
+            unsigned long long lit = (duration * sim.dwell) >> 16;
+            sample(lit, true);
+            DirectDrive::clear_matrix();
+            ++sim.stats.interrupts;
+            sample(duration - lit, false);
+        } else {
+            sample(duration, true);
+        }
+        ++sim.stats.ticks;
+        ++sim.stats.interrupts;
+        sim.prev_scale = sim.scale;
+        sim.scale = sim.next_scale;
+    }
+    return ticks;
+}
+
+unsigned int auto_drive_freq() {
+    return sim.freq;
+}
+
+const std::bitset<DirectDrive::num_leds> &last_tick() {
+    return sim.last;
+}
+
+const Stats &stats() {
+    return sim.stats;
+}
+
+void reset() {
+    sim.pcntr1[0] = 0;
+    sim.pcntr1[1] = 0;
+    sim.last.reset();
+    sim.stats = {};
+    scheduler = {};
+}
+
+}
+
+void enable_auto_drive(TimerFunction cb, unsigned int freq) {
+    sim.cb = cb;
+    sim.freq = cb?freq:0;
+    sim.scale = sim.next_scale = sim.prev_scale = 1;
+    sim.dwell = GammaTable::full_dwell;
+}
+
+void set_auto_drive_period_scale(unsigned int scale) {
+    sim.next_scale = scale;
+}
+
+void set_auto_drive_dwell(unsigned int dwell) {
+    sim.dwell = dwell;
+    if (dwell == 0) DirectDrive::clear_matrix();
+}
+
+int schedule_task(TimerFunction fn, unsigned int delay, unsigned int period) {
+    return scheduler.schedule(fn, delay, period);
+}
+
+bool cancel_task(int id) {
+    return scheduler.cancel(id);
+}
+
+uint32_t read_cycle_counter() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint32_t cycle_counter_freq() {
+    return 1000000000;
+}
+
+void set_auto_drive_stats(DriveStatsRecorder *rec) {
+    sim.stats_rec = rec;
+    sim.prev_interval = 0;
+}
+
+void disable_auto_drive() {
+    sim.cb = {};
+    sim.freq = 0;
+}
+
+}
+#endif
@@ -0,0 +1,102 @@
+#pragma once
+#include "DotMatrix.h"
+#include <bitset>
+
+namespace DotMatrix {
+
+///Host-side simulator of the LED matrix
+/**
+ * When the library is compiled outside of Arduino (ARDUINO is not defined),
+ * DotMatrixSim.cpp provides DirectDrive and enable_auto_drive() backend, which
+ * models the 11 charlieplexed lines instead of the MCU ports. This allows to run
+ * and measure the driver on a workstation.
+ *
+ * One tick is the interval between two calls of the driver. Call tick() after
+ * each Driver::drive() or use run_auto_drive() which calls the installed
+ * auto-drive function and samples the matrix for you. Ticks are weighted by
+ * set_auto_drive_period_scale() (binary code modulation) and split by
+ * set_auto_drive_dwell() (global brightness)
+ *
+ * @note LED index is y*12+x in landscape orientation
+ */
+namespace Simulator {
+
+    ///state of a matrix line
+    enum class Line {
+        ///line is not driven
+        high_z,
+        ///line is driven to 5V
+        high,
+        ///line is driven to 0V
+        low
+    };
+
+    ///accumulated statistics
+    struct Stats {
+        ///units of time per the shortest tick
+        static constexpr unsigned long long time_unit = 65536;
+        ///count of sampled ticks
+        unsigned long ticks = 0;
+        ///count of interrupts (ticks and blanking)
+        unsigned long interrupts = 0;
+        ///total time in time_unit
+        unsigned long long time = 0;
+        ///per LED time when LED was lit
+        unsigned long long on_time[DirectDrive::num_leds] = {};
+
+        ///retrieve duty cycle of LED
+        /**
+         * @param led index of LED
+         * @return ratio of time when the LED was lit (0.0 - 1.0)
+         */
+        double duty(unsigned int led) const {
+            return time?static_cast<double>(on_time[led])/time:0.0;
+        }
+        ///retrieve duty cycle of LED
+        /**
+         * @param x x coord in landscape orientation
+         * @param y y coord in landscape orientation
+         * @return ratio of time when the LED was lit (0.0 - 1.0)
+         */
+        double duty(unsigned int x, unsigned int y) const {
+            return duty(y * 12 + x);
+        }
+    };
+
+    ///retrieve current state of the line
+    /**
+     * @param line line number 0-10
+     * @return state of the line
+     */
+    Line line_state(unsigned int line);
+    ///determine whether LED is lit right now
+    /**
+     * @param led index of LED
+     * @retval true LED is lit
+     * @retval false LED is dark
+     */
+    bool is_lit(unsigned int led);
+    ///sample current state of the matrix as one tick
+    /**
+     * @param weight duration of the tick in multiples of the shortest tick,
+     * see Driver::tick_weight()
+     */
+    void tick(unsigned int weight = 1);
+    ///call function installed by enable_auto_drive() and sample each tick
+    /**
+     * @param ticks count of ticks to simulate
+     * @return count of simulated ticks. Returns 0 if auto drive is not enabled
+     */
+    unsigned int run_auto_drive(unsigned int ticks);
+    ///retrieve frequency passed to enable_auto_drive() (0 - disabled)
+    unsigned int auto_drive_freq();
+    ///retrieve LEDs lit during last sampled tick
+    const std::bitset<DirectDrive::num_leds> &last_tick();
+    ///retrieve accumulated statistics
+    const Stats &stats();
+    ///reset statistics, cancel scheduled tasks and turn all lines to high impedance
+    void reset();
+
+}
+
+}
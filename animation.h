@@ -0,0 +1,297 @@
+#pragma once
+#include <array>
+namespace DotMatrix {
+
+///duration of the frame which is displayed forever (animation stops)
+constexpr uint16_t animation_hold = 0xFFFF;
+
+///one frame of animation source
+/**
+ * Sources are used only during compilation by encode_animation()
+ */
+template<typename FrameBuffer>
+struct AnimationFrame {
+    ///content of the frame
+    FrameBuffer fb = {};
+    ///duration in milliseconds (animation_hold - stop)
+    uint16_t duration = 0;
+};
+
+///Convert frames in format of Arduino_LED_Matrix to animation source
+/**
+ * @tparam FrameBuffer type of frame buffer (12x8 landscape)
+ * @param words frames, 3 words of pixels (bit 31 of the first word is the top left pixel)
+ * and duration in milliseconds
+ * @return animation source
+ */
+template<typename FrameBuffer, std::size_t N>
+constexpr std::array<AnimationFrame<FrameBuffer>, N> frames_from_words(const uint32_t (&words)[N][4]) {
+    std::array<AnimationFrame<FrameBuffer>, N> out = {};
+    for (std::size_t f = 0; f < N; ++f) {
+        for (unsigned int i = 0; i < 96; ++i) {
+            out[f].fb.set_pixel(i % 12, i / 12, (words[f][i / 32] >> (31 - i % 32)) & 1);
+        }
+        out[f].duration = static_cast<uint16_t>(std::min<uint32_t>(words[f][3], animation_hold));
+    }
+    return out;
+}
+
+///Convert ascii art to animation frame
+/**
+ * @tparam FrameBuffer type of frame buffer
+ * @param asciiart string of exactly width*height characters. Space is 0, digit is
+ * pixel value, other character is the maximum value
+ * @param duration duration of the frame in milliseconds
+ * @return animation frame
+ */
+template<typename FrameBuffer>
+constexpr AnimationFrame<FrameBuffer> frame_from_ascii(const char *asciiart, uint16_t duration) {
+    AnimationFrame<FrameBuffer> out = {};
+    for (unsigned int y = 0; y < FrameBuffer::height; ++y) {
+        for (unsigned int x = 0; x < FrameBuffer::width; ++x) {
+            char c = *asciiart;
+            if (c >= '0' && c <= '9') out.fb.set_pixel(x, y, c - '0');
+            else if (c > 32) out.fb.set_pixel(x, y, FrameBuffer::mask);
+            ++asciiart;
+        }
+    }
+    if (*asciiart != 0) {
+        //string is too long, this fails in constexpr
+        out.fb.pixels[FrameBuffer::count_bytes] = 0;
+    }
+    out.duration = duration;
+    return out;
+}
+
+///Encode difference between two frames
+/**
+ * Stream of the frame starts by duration: 0x00 - same as previous frame,
+ * 0x01 followed by 2 bytes LE. Then tokens follow:
+ * 0x00-0x7F - skip 1-128 unchanged bytes, 0x80-0xFF - group of next 7 bytes,
+ * bit N of the token is set when byte N is changed, xor values of changed
+ * bytes follow. Tokens cover exactly count_bytes of the frame buffer.
+ *
+ * @param prev previous frame (zeroed for the first frame)
+ * @param cur current frame
+ * @param prev_duration duration of previous frame (0 - first frame)
+ * @param out output buffer, can be nullptr to count bytes only
+ * @return count of bytes
+ */
+template<typename FrameBuffer>
+constexpr unsigned int encode_animation_frame(const FrameBuffer &prev, const AnimationFrame<FrameBuffer> &cur,
+        unsigned int prev_duration, uint8_t *out) {
+    constexpr unsigned int count = FrameBuffer::count_bytes;
+    unsigned int sz = 0;
+    auto emit = [&](uint8_t b) {
+        if (out) out[sz] = b;
+        ++sz;
+    };
+    auto delta = [&](unsigned int i) -> uint8_t {
+        return i < count?prev.pixels[i] ^ cur.fb.pixels[i]:0;
+    };
+    if (cur.duration == prev_duration) {
+        emit(0);
+    } else {
+        emit(1);
+        emit(static_cast<uint8_t>(cur.duration));
+        emit(static_cast<uint8_t>(cur.duration >> 8));
+    }
+    unsigned int pos = 0;
+    while (pos < count) {
+        unsigned int n = 0;
+        while (n < 128 && pos + n < count && delta(pos + n) == 0) ++n;
+        if (n >= 7 || pos + n == count) {
+            emit(static_cast<uint8_t>(n - 1));
+            pos += n;
+        } else {
+            uint8_t m = 0x80;
+            for (unsigned int i = 0; i < 7; ++i) {
+                if (delta(pos + i)) m |= 1 << i;
+            }
+            emit(m);
+            for (unsigned int i = 0; i < 7; ++i) {
+                if (delta(pos + i)) emit(delta(pos + i));
+            }
+            pos += 7;
+        }
+    }
+    return sz;
+}
+
+///Compute size of encoded animation
+template<typename Frames>
+constexpr unsigned int encoded_animation_size(const Frames &frames) {
+    using FrameBuffer = std::decay_t<decltype(frames[0].fb)>;
+    FrameBuffer prev = {};
+    unsigned int prev_duration = 0;
+    unsigned int sz = 0;
+    for (const auto &f: frames) {
+        sz += encode_animation_frame(prev, f, prev_duration, nullptr);
+        prev = f.fb;
+        prev_duration = f.duration;
+    }
+    return sz;
+}
+
+///Delta encoded animation, create it by encode_animation()
+/**
+ * @tparam _FrameBuffer type of frame buffer
+ * @tparam _count count of frames
+ * @tparam _size size of data
+ */
+template<typename _FrameBuffer, unsigned int _count, unsigned int _size>
+struct Animation {
+    using FrameBuffer = _FrameBuffer;
+    ///count of frames
+    static constexpr unsigned int count_frames = _count;
+    ///size of encoded data
+    static constexpr unsigned int size = _size;
+    ///stream of frames, the first frame is delta from zeroed frame buffer (keyframe)
+    uint8_t data[_size] = {};
+};
+
+///Encode animation
+/**
+ * @tparam frames array of AnimationFrame (std::array or C array)
+ * @return Animation
+ *
+ * @code
+ * constexpr auto frames = DotMatrix::frames_from_words<MyFB>(raw_frames);
+ * constexpr auto anim = DotMatrix::encode_animation<frames>();
+ * @endcode
+ */
+template<const auto &frames>
+constexpr auto encode_animation() {
+    using FrameBuffer = std::decay_t<decltype(frames[0].fb)>;
+    constexpr unsigned int count = sizeof(frames) / sizeof(frames[0]);
+    constexpr unsigned int sz = encoded_animation_size(frames);
+    Animation<FrameBuffer, count, sz> out = {};
+    FrameBuffer prev = {};
+    unsigned int prev_duration = 0;
+    unsigned int pos = 0;
+    for (const auto &f: frames) {
+        pos += encode_animation_frame(prev, f, prev_duration, out.data + pos);
+        prev = f.fb;
+        prev_duration = f.duration;
+    }
+    return out;
+}
+
+///Plays delta encoded animation
+/**
+ * Decoding of a frame costs at most count_bytes copied bytes (previous
+ * frame), count_bytes xored bytes and one token per 7 bytes. Frames are timed
+ * by State::counter, so they stay in step with the scan
+ *
+ * @tparam Animation type of animation
+ */
+template<typename Animation>
+class AnimationPlayer {
+public:
+    using FrameBuffer = typename Animation::FrameBuffer;
+
+    ///construct player
+    /**
+     * @param anim animation
+     * @param loop true - repeat animation, false - stop at the last frame
+     */
+    constexpr AnimationPlayer(const Animation &anim, bool loop = true)
+        :_anim(anim), _loop(loop) {}
+
+    ///restart animation from the first frame
+    void rewind() {
+        _pos = 0;
+        _started = false;
+        _last = nullptr;
+    }
+
+    ///decode next frame
+    /**
+     * @param fb frame buffer, it must contain the previous decoded frame
+     * (any content for the first frame)
+     * @return duration of the frame in milliseconds
+     */
+    uint16_t decode_next(FrameBuffer &fb) {
+        if (_pos >= Animation::size) {
+            _pos = 0;
+        }
+        if (_pos == 0) {
+            fb.clear();
+            _frame_duration = 0;
+        }
+        const uint8_t *d = _anim.data + _pos;
+        if (*d++) {
+            _frame_duration = static_cast<uint16_t>(d[0] | (d[1] << 8));
+            d += 2;
+        }
+        unsigned int pos = 0;
+        while (pos < FrameBuffer::count_bytes) {
+            uint8_t t = *d++;
+            if (t & 0x80) {
+                //the last group can be shorter, its bits past the frame are never set
+                unsigned int n = std::min(7U, FrameBuffer::count_bytes - pos);
+                for (unsigned int i = 0; i < n; ++i) {
+                    if (t & (1 << i)) fb.pixels[pos + i] ^= *d++;
+                }
+                pos += 7;
+            } else {
+                pos += t + 1;
+            }
+        }
+        _pos = d - _anim.data;
+        return _frame_duration;
+    }
+
+    ///update animation, call it from the main loop
+    /**
+     * Decodes the next frame into back buffer and presents it when
+     * the current frame expires.
+     *
+     * @param st state of driving
+     * @param chain swap chain, which is displayed
+     * @retval true new frame presented
+     * @retval false nothing changed
+     */
+    template<unsigned int N>
+    bool update(const State &st, SwapChain<FrameBuffer, N> &chain) {
+        if (_started) {
+            if (_duration == animation_hold) return false;
+            if (!_loop && _pos >= Animation::size) return false;
+            if (st.counter - _start < _due) return false;
+            _start += _due;
+        } else {
+            _start = st.counter;
+            _started = true;
+        }
+        FrameBuffer &fb = chain.back();
+        if (_last && _pos != 0 && _pos < Animation::size) fb = *_last;
+        _duration = decode_next(fb);
+        _due = static_cast<uint32_t>(_duration) * rows_per_second / 1000 * ticks_per_row;
+        _last = &fb;
+        chain.present();
+        return true;
+    }
+
+    ///test whether animation is stopped
+    bool finished() const {
+        return _started && (_duration == animation_hold || (!_loop && _pos >= Animation::size));
+    }
+
+protected:
+    static constexpr unsigned int ticks_per_row =
+            FrameBuffer::bcm_bits?FrameBuffer::bcm_bits:FrameBuffer::bits_per_pixel;
+    static constexpr unsigned int rows_per_second = FrameBuffer::recommended_refresh_freq
+            / (FrameBuffer::bcm_bits?(1U << FrameBuffer::bcm_bits) - 1:FrameBuffer::bits_per_pixel);
+
+    const Animation &_anim;
+    bool _loop;
+    bool _started = false;
+    uint16_t _duration = 0;
+    uint16_t _frame_duration = 0;
+    unsigned int _pos = 0;
+    unsigned int _start = 0;
+    unsigned int _due = 0;
+    const FrameBuffer *_last = nullptr;
+};
+
+}
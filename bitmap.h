@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <type_traits>
 #include <string_view>
+#include <algorithm>
+#include <utility>
 namespace DotMatrix {
 
 ///define bitmap blt operation
@@ -82,7 +84,7 @@ public:
      */
 
     constexpr void set_pixel(unsigned int x, unsigned int y) {
-        bitmap[y][x >> 3] |= static_cast<uint8_t>(1) << (x & 0x7);
+        bitmap[y * line_width + (x >> 3)] |= static_cast<uint8_t>(1) << (x & 0x7);
     }
     ///get value of pixel
     /**
@@ -91,19 +93,42 @@ public:
      * @return value
      */
     constexpr bool get_pixel(unsigned int x, unsigned int y) const {
-        return (bitmap[y][x >> 3] & (1 << (x & 0x7))) != 0;
+        return (bitmap[y * line_width + (x >> 3)] & (1 << (x & 0x7))) != 0;
     }
+    ///retrieve raw data of a row
+    /**
+     * @param y row
+     * @return pointer to line_width bytes, bit 0 of the first byte is the left pixel
+     */
+    constexpr const uint8_t *get_row(unsigned int y) const {
+        return bitmap + y * line_width;
+    }
+    ///retrieve 8 pixels of a row
+    /**
+     * @param x x coord of the first pixel
+     * @param y y coord
+     * @return pixels, bit 0 is pixel at x. Pixels beyond the row are undefined
+     */
+    constexpr uint8_t get_bits(unsigned int x, unsigned int y) const {
+        unsigned int i = x >> 3;
+        unsigned int s = x & 7;
+        const uint8_t *r = get_row(y);
+        unsigned int v = r[i] >> s;
+        if (s && i + 1 < line_width) v |= r[i + 1] << (8 - s);
+        return static_cast<uint8_t>(v);
+    }
+
+    ///construct empty bitmap
+    constexpr Bitmap() = default;
 
     ///initialize bitmap from raw data
     /**
      * @param data raw data, 1 byte = 8 pixels
      */
     constexpr Bitmap(const uint8_t *data) {
-        for (auto &a: bitmap) {
-            for (auto &b: a) {
-                b = *data;
-                ++data;
-            }
+        for (auto &b: bitmap) {
+            b = *data;
+            ++data;
         }
     }
 
@@ -125,7 +150,7 @@ public:
             }
         }
         if (*asciiart != 0) {
-            bitmap[height][2] = 1;
+            bitmap[height * line_width + 2] = 1;
         }
     }
 
@@ -135,9 +160,449 @@ public:
             Rotation r = Rotation::rot0) const;
 
 protected:
-    uint8_t bitmap[height][line_width] = { };
+    ///rows of line_width bytes
+    uint8_t bitmap[height * line_width] = { };
+};
+
+///Source of the blit engine
+/**
+ * Describes any 1 bit image stored as a bitstream: pixel (x,y) is the bit
+ * offset + y*stride + x, bit 0 of a byte is the first one. Columns from
+ * stored_width to width are zero. Bitmap, PackedGlyph and BitmapView
+ * convert to it by blit_source()
+ */
+struct BlitSource {
+    ///bitstream
+    const uint8_t *data = nullptr;
+    ///position of pixel (0,0) in bits
+    unsigned int offset = 0;
+    ///distance between rows in bits
+    unsigned int stride = 0;
+    ///count of stored columns
+    unsigned int stored_width = 0;
+    ///width in pixels
+    int width = 0;
+    ///height in pixels
+    int height = 0;
+
+    ///retrieve width
+    constexpr int get_width() const {
+        return width;
+    }
+    ///retrieve height
+    constexpr int get_height() const {
+        return height;
+    }
+    ///retrieve 8 pixels of a row
+    /**
+     * @param x x coord of the first pixel
+     * @param y y coord
+     * @return pixels, bit 0 is pixel at x. Pixels beyond stored columns are zero
+     */
+    constexpr uint8_t get_bits(unsigned int x, unsigned int y) const {
+        if (x >= stored_width) return 0;
+        unsigned int n = std::min<unsigned int>(8, stored_width - x);
+        unsigned int pos = offset + y * stride + x;
+        unsigned int s = pos & 7;
+        unsigned int v = data[pos >> 3] >> s;
+        if (s + n > 8) v |= data[(pos >> 3) + 1] << (8 - s);
+        return static_cast<uint8_t>(v & ((1U << n) - 1));
+    }
+    ///get value of pixel
+    constexpr bool get_pixel(unsigned int x, unsigned int y) const {
+        return get_bits(x, y) & 1;
+    }
 };
 
+///identity
+constexpr BlitSource blit_source(const BlitSource &src) {
+    return src;
+}
+
+///describe bitmap
+template<unsigned int w, unsigned int h>
+constexpr BlitSource blit_source(const Bitmap<w, h> &bm) {
+    return {bm.get_row(0), 0, Bitmap<w, h>::line_width * 8, w, static_cast<int>(w), static_cast<int>(h)};
+}
+
+///Target of the blit engine
+/**
+ * Pixel i of the frame buffer occupies bits starting at i*bits_per_pixel
+ * in the pixels array (the layout of FrameBuffer::set_pixel). 1 and 2 bits per pixel
+ * are supported
+ */
+struct BlitTarget {
+    ///pixels of frame buffer
+    uint8_t *pixels = nullptr;
+    ///width in pixels
+    unsigned int width = 0;
+    ///height in pixels
+    unsigned int height = 0;
+    ///bits per pixel
+    unsigned int bits_per_pixel = 1;
+};
+
+///describe frame buffer
+template<typename FrameBuffer>
+constexpr BlitTarget blit_target(FrameBuffer &fb) {
+    return {fb.pixels, FrameBuffer::width, FrameBuffer::height, FrameBuffer::bits_per_pixel};
+}
+
+///Blit kernels working with whole bytes of the frame buffer
+/**
+ * Kernels are compiled once per operation, sizes, rotation and format of the
+ * frame buffer are passed at runtime by descriptors
+ *
+ * @tparam op operation
+ */
+template<BltOp op>
+struct BlitKernel {
+
+    ///spread bits to bits_per_pixel (bit N to bits 2N and 2N+1 for 2 bits per pixel)
+    static constexpr uint32_t expand(uint32_t bits, unsigned int bpp) {
+        if (bpp == 1) return bits;
+        bits = (bits | (bits << 4)) & 0x0F0F;
+        bits = (bits | (bits << 2)) & 0x3333;
+        bits = (bits | (bits << 1)) & 0x5555;
+        return bits * 3;
+    }
+
+    ///repeat color in all pixels of a word
+    static constexpr uint32_t pattern(uint8_t color, unsigned int bpp) {
+        if (bpp == 1) return (color & 1)?0xFFFF:0;
+        return (color & 3) * 0x5555;
+    }
+
+    ///write up to 8 pixels of a row
+    /**
+     * @param pixels frame buffer's pixels
+     * @param bitpos bit position of the first pixel
+     * @param bits source bits, bit 0 is the first pixel
+     * @param count count of pixels (1-8)
+     * @param colors colors
+     * @param bpp bits per pixel
+     */
+    static constexpr void span(uint8_t *pixels, unsigned int bitpos, uint8_t bits,
+            unsigned int count, const ColorMap &colors, unsigned int bpp) {
+        uint32_t m = expand((static_cast<uint32_t>(1) << count) - 1, bpp);
+        uint32_t v = expand(bits, bpp) & m;
+        uint32_t fg = pattern(colors.foreground, bpp);
+        uint32_t bg = pattern(colors.background, bpp);
+        uint32_t set = m;
+        uint32_t val = 0;
+        if constexpr (op == BltOp::xor_op) {
+            val = ((v & fg) | (~v & bg)) & m;
+        } else if constexpr (op == BltOp::and_op) {
+            set = m & ~v; val = bg;
+        } else if constexpr (op == BltOp::or_op) {
+            set = v; val = fg;
+        } else if constexpr (op == BltOp::nand_op) {
+            set = m & ~v; val = fg;
+        } else if constexpr (op == BltOp::nor_op) {
+            set = v; val = bg;
+        } else if constexpr (op == BltOp::copy_neg) {
+            val = (v & bg) | (~v & fg);
+        } else {
+            val = (v & fg) | (~v & bg);
+        }
+        unsigned int shift = bitpos & 7;
+        uint8_t *p = pixels + (bitpos >> 3);
+        set <<= shift;
+        val <<= shift;
+        for (unsigned int i = 0; i < 3 && set; ++i, set >>= 8, val >>= 8) {
+            uint8_t bm = static_cast<uint8_t>(set);
+            if constexpr (op == BltOp::xor_op) {
+                p[i] ^= static_cast<uint8_t>(val);
+            } else if (bm) {
+                p[i] = static_cast<uint8_t>((p[i] & ~bm) | (val & bm));
+            }
+        }
+    }
+
+    ///write up to 8 pixels of a row, clip pixels outside of the frame buffer
+    /**
+     * @param fb frame buffer
+     * @param col column of the first pixel
+     * @param row row
+     * @param bits source bits, bit 0 is the first pixel
+     * @param count count of pixels (1-8)
+     * @param colors colors
+     * @param dirty extended by written pixels
+     */
+    static constexpr void clipped_span(const BlitTarget &fb, int col, int row, uint8_t bits,
+            int count, const ColorMap &colors, DirtyRegion &dirty) {
+        if (row < 0 || row >= static_cast<int>(fb.height)) return;
+        //also keeps the shift below the width of int
+        if (col + count <= 0) return;
+        if (col < 0) {
+            bits >>= -col;
+            count += col;
+            col = 0;
+        }
+        count = std::min(count, static_cast<int>(fb.width) - col);
+        if (count <= 0) return;
+        dirty.extend(col, row, col + count - 1, row);
+        span(fb.pixels, (row * fb.width + col) * fb.bits_per_pixel, bits, count, colors, fb.bits_per_pixel);
+    }
+
+    ///write up to 8 pixels of a row of the frame buffer, clip and mark them dirty
+    template<typename FrameBuffer>
+    static constexpr void clipped_span(FrameBuffer &fb, int col, int row, uint8_t bits,
+            int count, const ColorMap &colors) {
+        DirtyRegion d = {};
+        clipped_span(blit_target(fb), col, row, bits, count, colors, d);
+        if (!d.empty()) mark_dirty(fb, d.x0, d.y0, d.x1, d.y1);
+    }
+
+    ///transpose 8x8 bit matrix
+    /**
+     * @param x byte N is row N, bit M is column M
+     * @return byte N is column N, bit M is row M
+     */
+    static constexpr uint64_t transpose8(uint64_t x) {
+        uint64_t t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+        x = x ^ t ^ (t << 7);
+        t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+        x = x ^ t ^ (t << 14);
+        t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+        x = x ^ t ^ (t << 28);
+        return x;
+    }
+
+    ///reverse order of bits in a byte
+    static constexpr uint8_t reverse8(uint8_t b) {
+        b = static_cast<uint8_t>((b >> 4) | (b << 4));
+        b = static_cast<uint8_t>(((b & 0xCC) >> 2) | ((b & 0x33) << 2));
+        b = static_cast<uint8_t>(((b & 0xAA) >> 1) | ((b & 0x55) << 1));
+        return b;
+    }
+
+    ///blit rotated tile up to 8x8 pixels
+    /**
+     * @param fb frame buffer
+     * @param rot rotation (rot90, rot180, rot270)
+     * @param rows rows of the tile, bit 0 is left pixel
+     * @param w width of the tile (1-8)
+     * @param h height of the tile (1-8)
+     * @param col column where left top corner of the tile is mapped
+     * @param row row where left top corner of the tile is mapped
+     * @param colors colors
+     * @param dirty extended by written pixels
+     */
+    static constexpr void tile(const BlitTarget &fb, Rotation rot, const uint8_t *rows, int w, int h,
+            int col, int row, const ColorMap &colors, DirtyRegion &dirty) {
+        if (rot == Rotation::rot180) {
+            for (int y = 0; y < h; ++y) {
+                uint8_t bits = static_cast<uint8_t>(reverse8(rows[y]) >> (8 - w));
+                clipped_span(fb, col - w + 1, row - y, bits, w, colors, dirty);
+            }
+        } else {
+            uint64_t m = 0;
+            for (int y = 0; y < h; ++y) {
+                m |= static_cast<uint64_t>(rows[y]) << (8 * y);
+            }
+            m = transpose8(m);
+            for (int x = 0; x < w; ++x) {
+                uint8_t bits = static_cast<uint8_t>(m >> (8 * x));
+                if (rot == Rotation::rot90) {
+                    clipped_span(fb, col - h + 1, row + x,
+                            static_cast<uint8_t>(reverse8(bits) >> (8 - h)), h, colors, dirty);
+                } else {
+                    clipped_span(fb, col, row - x, bits, h, colors, dirty);
+                }
+            }
+        }
+    }
+
+    ///copy whole bitmap with rotation, by tiles 8x8
+    /**
+     * @param bm source
+     * @param fb frame buffer
+     * @param rot rotation (rot90, rot180, rot270)
+     * @param col column where left upper corner of bitmap is mapped
+     * @param row row where left upper corner of bitmap is mapped
+     * @param colors colors
+     * @param dirty extended by written pixels
+     */
+    static constexpr void rotated(const BlitSource &bm, const BlitTarget &fb, Rotation rot,
+            int col, int row, const ColorMap &colors, DirtyRegion &dirty) {
+        int bw = bm.get_width();
+        int bh = bm.get_height();
+        for (int ty = 0; ty < bh; ty += 8) {
+            int h = std::min(8, bh - ty);
+            for (int tx = 0; tx < bw; tx += 8) {
+                int w = std::min(8, bw - tx);
+                uint8_t rows[8] = {};
+                for (int y = 0; y < h; ++y) {
+                    rows[y] = bm.get_bits(tx, ty + y);
+                }
+                if (rot == Rotation::rot90) {
+                    tile(fb, rot, rows, w, h, col - ty, row + tx, colors, dirty);
+                } else if (rot == Rotation::rot180) {
+                    tile(fb, rot, rows, w, h, col - tx, row - ty, colors, dirty);
+                } else {
+                    tile(fb, rot, rows, w, h, col + ty, row - tx, colors, dirty);
+                }
+            }
+        }
+    }
+
+    ///copy whole bitmap without rotation
+    /**
+     * Bitmap is clipped once, then each row is transfered by 8 pixels
+     *
+     * @param bm source
+     * @param fb frame buffer
+     * @param col column of left top corner
+     * @param row row of left top corner
+     * @param colors colors
+     * @param dirty extended by written pixels
+     */
+    static constexpr void rect(const BlitSource &bm, const BlitTarget &fb, int col, int row,
+            const ColorMap &colors, DirtyRegion &dirty) {
+        unsigned int bpp = fb.bits_per_pixel;
+        int x0 = col < 0?-col:0;
+        int y0 = row < 0?-row:0;
+        int x1 = std::min<int>(bm.get_width(), static_cast<int>(fb.width) - col);
+        int y1 = std::min<int>(bm.get_height(), static_cast<int>(fb.height) - row);
+        if (x0 >= x1 || y0 >= y1) return;
+        dirty.extend(col + x0, row + y0, col + x1 - 1, row + y1 - 1);
+        for (int y = y0; y < y1; ++y) {
+            unsigned int dst = ((row + y) * fb.width + col + x0) * bpp;
+            for (int x = x0; x < x1; x += 8, dst += 8 * bpp) {
+                unsigned int n = std::min(8, x1 - x);
+                span(fb.pixels, dst, bm.get_bits(x, y), n, colors, bpp);
+            }
+        }
+    }
+
+    ///copy bitmap
+    /**
+     * @param bm source
+     * @param fb frame buffer
+     * @param rot rotation
+     * @param col column where left upper corner of bitmap is mapped
+     * @param row row where left upper corner of bitmap is mapped
+     * @param colors colors
+     * @return region of written pixels
+     */
+    static constexpr DirtyRegion blit(const BlitSource &bm, const BlitTarget &fb, Rotation rot,
+            int col, int row, const ColorMap &colors) {
+        DirtyRegion dirty = {};
+        if (rot == Rotation::rot0) rect(bm, fb, col, row, colors, dirty);
+        else rotated(bm, fb, rot, col, row, colors, dirty);
+        return dirty;
+    }
+};
+
+///Copy bitmap by the blit engine
+/**
+ * Dispatches to the kernel of the operation. This is the only code
+ * of the blitting, it is shared by all bitmaps and frame buffers
+ *
+ * @param bm source
+ * @param fb frame buffer
+ * @param op operation
+ * @param rot rotation
+ * @param col column where left upper corner of bitmap is mapped
+ * @param row row where left upper corner of bitmap is mapped
+ * @param colors colors
+ * @return region of written pixels
+ */
+constexpr DirtyRegion blit(const BlitSource &bm, const BlitTarget &fb, BltOp op, Rotation rot,
+        int col, int row, const ColorMap &colors = {}) {
+    switch (op) {
+        default:
+        case BltOp::copy: return BlitKernel<BltOp::copy>::blit(bm, fb, rot, col, row, colors);
+        case BltOp::and_op: return BlitKernel<BltOp::and_op>::blit(bm, fb, rot, col, row, colors);
+        case BltOp::or_op: return BlitKernel<BltOp::or_op>::blit(bm, fb, rot, col, row, colors);
+        case BltOp::xor_op: return BlitKernel<BltOp::xor_op>::blit(bm, fb, rot, col, row, colors);
+        case BltOp::nand_op: return BlitKernel<BltOp::nand_op>::blit(bm, fb, rot, col, row, colors);
+        case BltOp::nor_op: return BlitKernel<BltOp::nor_op>::blit(bm, fb, rot, col, row, colors);
+        case BltOp::copy_neg: return BlitKernel<BltOp::copy_neg>::blit(bm, fb, rot, col, row, colors);
+    }
+}
+
+///determines whether blit can use the blit engine
+template<typename Bitmap, typename FrameBuffer, typename = void>
+struct BlitKernelSupported : std::false_type {};
+
+template<typename Bitmap, typename FrameBuffer>
+struct BlitKernelSupported<Bitmap, FrameBuffer, std::void_t<
+        decltype(blit_source(std::declval<const Bitmap &>())),
+        decltype(std::declval<FrameBuffer &>().pixels[0] = 0)> >
+    : std::bool_constant<(FrameBuffer::bits_per_pixel == 1 || FrameBuffer::bits_per_pixel == 2)
+                         && FrameBuffer::byte_swizzle == 0> {};
+
+///Copy bitmap pixel by pixel (frame buffers not supported by the blit engine)
+template <typename Bitmap, typename FrameBuffer>
+constexpr void blit_pixels(const Bitmap &bm, FrameBuffer &fb, int col, int row,
+        const ColorMap &colors, BltOp op, Rotation rot) {
+    int h = bm.get_height();
+    int w = bm.get_width();
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            unsigned int r = 0;
+            unsigned int c = 0;
+            switch (rot) {
+                default:
+                case Rotation::rot0: r = y + row; c = x + col; break;
+                case Rotation::rot90: r = x + row; c = col - y; break;
+                case Rotation::rot180: r = row - y; c = col - x; break;
+                case Rotation::rot270: r = row - x; c = y + col; break;
+            }
+            bool v = bm.get_pixel(x, y);
+            switch (op) {
+                case BltOp::xor_op:
+                    fb.set_pixel(c, r, fb.get_pixel(c, r) ^ (v ? colors.foreground : colors.background));
+                    break;
+                case BltOp::and_op:
+                    if (!v) fb.set_pixel(c, r, colors.background);
+                    break;
+                case BltOp::or_op:
+                    if (v) fb.set_pixel(c, r, colors.foreground);
+                    break;
+                case BltOp::nand_op:
+                    if (!v) fb.set_pixel(c, r, colors.foreground);
+                    break;
+                case BltOp::nor_op:
+                    if (v) fb.set_pixel(c, r, colors.background);
+                    break;
+                case BltOp::copy_neg:
+                    fb.set_pixel(c, r, v ? colors.background : colors.foreground);
+                    break;
+                default:
+                    fb.set_pixel(c, r, v ? colors.foreground : colors.background);
+                    break;
+            }
+        }
+    }
+}
+
+///Copy bitmap with operation and rotation selected at runtime
+/**
+ * Frame buffers with 1 or 2 bits per pixel use the blit engine, others are
+ * written pixel by pixel
+ *
+ * @param bm bitmap (Bitmap, BitmapView, PackedGlyph, or anything with get_pixel())
+ * @param fb target frame buffer
+ * @param col column (x coord) where left upper corner of bitmap is mapped
+ * @param row row (y coord) where left upper corner of bitmap is mapped
+ * @param colors specifies colors of each pixel state
+ * @param op operation
+ * @param rot rotation
+ */
+template <typename Bitmap, typename FrameBuffer>
+constexpr void draw_bitmap(const Bitmap &bm, FrameBuffer &fb, int col, int row,
+        const ColorMap &colors = {}, BltOp op = BltOp::copy, Rotation rot = Rotation::rot0) {
+    if constexpr(BlitKernelSupported<Bitmap, FrameBuffer>::value) {
+        DirtyRegion d = blit(blit_source(bm), blit_target(fb), op, rot, col, row, colors);
+        if (!d.empty()) mark_dirty(fb, d.x0, d.y0, d.x1, d.y1);
+    } else {
+        blit_pixels(bm, fb, col, row, colors, op, rot);
+    }
+}
+
 ///Defines blt function parameters
 /**
  * @tparam op operation
@@ -159,48 +624,12 @@ struct BitBlt {
     template <typename Bitmap, typename FrameBuffer>
     static constexpr void bitblt(const Bitmap &bm, FrameBuffer &fb, int col, int row,
         const ColorMap &colors = { }) {
-        auto h = bm.get_height();
-        auto w = bm.get_width();
-        for (int y = 0; y < h; ++y) {
-            for (int x = 0; x < w; ++x) {
-                unsigned int r = 0;
-                unsigned int c = 0;
-                if constexpr(rot == Rotation::rot0) {
-                    r = y + row;
-                    c = x + col;
-                } else if constexpr(rot == Rotation::rot90) {
-                    r = x + row;
-                    c = col - y;
-                } else if constexpr(rot == Rotation::rot180) {
-                    r = row - y;
-                    c = col - x;
-                } else if constexpr(rot == Rotation::rot270) {
-                    r = row - x;
-                    c = y + col;
-                }
-                auto v = bm.get_pixel(x, y);
-                if constexpr (op == BltOp::xor_op) {
-                    auto cc = fb.get_pixel(c, r);
-                    fb.set_pixel(c, r,
-                            cc ^ (v ? colors.foreground : colors.background));
-                } else if constexpr (op == BltOp::and_op) {
-                    if (!v)
-                        fb.set_pixel(c, r, colors.background);
-                } else if constexpr (op == BltOp::or_op) {
-                    if (v)
-                        fb.set_pixel(c, r, colors.foreground);
-                } else if constexpr (op == BltOp::nand_op) {
-                    if (!v)
-                        fb.set_pixel(c, r, colors.foreground);
-                } else if constexpr (op == BltOp::nor_op) {
-                    if (v)
-                        fb.set_pixel(c, r, colors.background);
-                } else if constexpr (op == BltOp::copy_neg) {
-                    fb.set_pixel(c, r, v ? colors.background : colors.foreground);
-                } else {
-                    fb.set_pixel(c, r, v ? colors.foreground : colors.background);
-                }
-            }
+        if constexpr(BlitKernelSupported<Bitmap, FrameBuffer>::value) {
+            //only the kernel of this operation is linked
+            DirtyRegion d = BlitKernel<op>::blit(blit_source(bm), blit_target(fb), rot, col, row, colors);
+            if (!d.empty()) mark_dirty(fb, d.x0, d.y0, d.x1, d.y1);
+        } else {
+            blit_pixels(bm, fb, col, row, colors, op, rot);
         }
     }
 };
@@ -209,43 +638,49 @@ struct BitBlt {
 /**
  * Can be initialized by any bitmap without knowing exact type (because Bitmap is template);
  * It is initialized as view - as a reference. You still need original bitmap
- * to access pixels
+ * to access pixels. The view is drawn by the blit engine as the bitmap itself
  *
  */
 class BitmapView {
 public:
     ///retrieve width
-    int get_width() const {
-        return width;
+    constexpr int get_width() const {
+        return _src.width;
     }
     ///retrieve height
-    int get_height() const {
-        return height;
+    constexpr int get_height() const {
+        return _src.height;
     }
     ///retrieve pixel
-    uint8_t get_pixel(int w, int h) const {
-        return get_pixel_fn(*this, w, h);
+    constexpr uint8_t get_pixel(int x, int y) const {
+        if (x < 0 || y < 0 || x >= _src.width || y >= _src.height) return 0;
+        return _src.get_pixel(x, y);
+    }
+    ///retrieve 8 pixels of a row
+    constexpr uint8_t get_bits(unsigned int x, unsigned int y) const {
+        return _src.get_bits(x, y);
+    }
+    ///retrieve descriptor
+    constexpr const BlitSource &source() const {
+        return _src;
     }
 
     ///construct view from the bitmap
-    template<int _w, int _h>
-    BitmapView(const Bitmap<_w, _h> &bp) :
-            width(_w), height(_h), ref(&bp), get_pixel_fn(
-                    [](const BitmapView &me, int w, int h) {
-                        auto b = reinterpret_cast<const Bitmap<_h, _w>*>(me.ref);
-                        if (w < _w && h < _h) {
-                            return b->set_pixel(w, h);
-                        }
-                        return false;
-                    }) {
-    }
+    template<unsigned int _w, unsigned int _h>
+    constexpr BitmapView(const Bitmap<_w, _h> &bm):_src(blit_source(bm)) {}
+
+    ///construct view from descriptor
+    constexpr BitmapView(const BlitSource &src):_src(src) {}
+
 protected:
-    int width;
-    int height;
-    const void *ref;
-    uint8_t (*get_pixel_fn)(const BitmapView&, int, int) = nullptr;
+    BlitSource _src;
 };
 
+///describe bitmap view
+constexpr BlitSource blit_source(const BitmapView &view) {
+    return view.source();
+}
+
 ///helper class for fonts
 /**
  * Just alias of Bitmap, note that height and with are swapped, because
@@ -301,6 +736,158 @@ struct FontFaceSpec<FontFace<height,width> > {
     }
 };
 
+///Glyph of PackedFont
+/**
+ * Acts as a bitmap of max_width x height pixels. Bits are read directly
+ * from the bitstream of the font
+ */
+template<unsigned int height, unsigned int max_width>
+struct PackedGlyph {
+    ///bitstream of the font
+    const uint8_t *data;
+    ///offset of the glyph in bits
+    uint16_t bit_offset;
+    ///count of stored columns
+    uint8_t ink_width;
+    ///advance width
+    uint8_t width;
+
+    ///retrieve with
+    static constexpr int get_width() {
+        return max_width;
+    }
+    ///retrieve height
+    static constexpr int get_height() {
+        return height;
+    }
+    ///retrieve 8 pixels of a row
+    /**
+     * @param x x coord of the first pixel
+     * @param y y coord
+     * @return pixels, bit 0 is pixel at x. Pixels not stored in the bitstream are zero
+     */
+    constexpr uint8_t get_bits(unsigned int x, unsigned int y) const {
+        if (x >= ink_width) return 0;
+        unsigned int pos = bit_offset + y * ink_width + x;
+        unsigned int v = (data[pos >> 3] | (data[(pos >> 3) + 1] << 8)) >> (pos & 7);
+        unsigned int n = std::min<unsigned int>(8, ink_width - x);
+        return static_cast<uint8_t>(v & ((1U << n) - 1));
+    }
+    ///get value of pixel
+    constexpr bool get_pixel(unsigned int x, unsigned int y) const {
+        return get_bits(x, y) & 1;
+    }
+};
+
+///describe glyph of packed font
+template<unsigned int height, unsigned int max_width>
+constexpr BlitSource blit_source(const PackedGlyph<height, max_width> &g) {
+    return {g.data, g.bit_offset, g.ink_width, g.ink_width, static_cast<int>(max_width), static_cast<int>(height)};
+}
+
+///Font packed to a bitstream
+/**
+ * Each glyph stores only ink_width x height bits row by row, where ink_width
+ * excludes empty columns on the right side of the glyph. Offset table contains
+ * offset of every 8th glyph, offsets of glyphs between are computed from
+ * ink widths. Create the font by pack_font()
+ *
+ * @tparam height height of the glyph
+ * @tparam max_width width of the face of the original font (max 15)
+ * @tparam data_bytes size of the bitstream (offsets are 16 bit, so the bitstream
+ * is limited to 65535 bits, 8 KB)
+ */
+template<unsigned int height, unsigned int max_width, unsigned int data_bytes>
+struct PackedFont {
+    static_assert(max_width < 16, "Glyph is too wide to be packed");
+
+    ///offsets of every 8th glyph in bits
+    uint16_t offset[12] = {};
+    ///ink width (bits 0-3) and advance width (bits 4-7) of glyphs
+    uint8_t metrics[96] = {};
+    ///bitstream (one byte of padding at the end)
+    uint8_t data[data_bytes] = {};
+
+    ///access glyph
+    constexpr PackedGlyph<height, max_width> operator[](unsigned int idx) const {
+        unsigned int pos = offset[idx >> 3];
+        for (unsigned int i = idx & ~7U; i < idx; ++i) {
+            pos += (metrics[i] & 0xF) * height;
+        }
+        return {data, static_cast<uint16_t>(pos),
+                static_cast<uint8_t>(metrics[idx] & 0xF),
+                static_cast<uint8_t>(metrics[idx] >> 4)};
+    }
+};
+
+///specialization for packed font
+template<unsigned int height, unsigned int max_width>
+struct FontFaceSpec<PackedGlyph<height, max_width> > {
+    const PackedGlyph<height, max_width> &ch;
+    constexpr uint8_t get_width() const {
+        return ch.width;
+    }
+    constexpr const PackedGlyph<height, max_width> &get_face() const {
+        return ch;
+    }
+};
+
+///calculate width of glyph without empty columns on the right side
+template<typename Face>
+constexpr unsigned int glyph_ink_width(const Face &face) {
+    unsigned int iw = 0;
+    for (unsigned int y = 0; y < static_cast<unsigned int>(face.get_height()); ++y) {
+        for (unsigned int x = iw; x < static_cast<unsigned int>(face.get_width()); ++x) {
+            if (face.get_pixel(x, y)) iw = x + 1;
+        }
+    }
+    return iw;
+}
+
+///calculate size of bitstream of packed font in bits
+template<typename Font>
+constexpr unsigned int packed_font_bits(const Font &font) {
+    using Spec = FontFaceSpec<std::decay_t<decltype(font[0])> >;
+    unsigned int bits = 0;
+    for (unsigned int i = 0; i < 96; ++i) {
+        const auto &face = Spec{font[i]}.get_face();
+        bits += glyph_ink_width(face) * face.get_height();
+    }
+    return bits;
+}
+
+///Pack font to the bitstream at compile time
+/**
+ * @tparam font source font (fixed or proportional)
+ * @return PackedFont
+ *
+ * @code
+ * constexpr auto font_6p_packed = DotMatrix::pack_font<DotMatrix::font_6p>();
+ * @endcode
+ */
+template<const auto &font>
+constexpr auto pack_font() {
+    using Spec = FontFaceSpec<std::decay_t<decltype(font[0])> >;
+    using Face = std::decay_t<decltype(Spec{font[0]}.get_face())>;
+    constexpr unsigned int bits = packed_font_bits(font);
+    static_assert(bits < 0x10000, "Packed font is too large, offsets of glyphs are 16 bit");
+    PackedFont<Face::h, Face::w, (bits + 7) / 8 + 1> out = {};
+    unsigned int pos = 0;
+    for (unsigned int i = 0; i < 96; ++i) {
+        Spec spec{font[i]};
+        const auto &face = spec.get_face();
+        unsigned int iw = glyph_ink_width(face);
+        if ((i & 7) == 0) out.offset[i >> 3] = static_cast<uint16_t>(pos);
+        out.metrics[i] = static_cast<uint8_t>(iw | (std::min<unsigned int>(spec.get_width(), 15) << 4));
+        for (unsigned int y = 0; y < Face::h; ++y) {
+            for (unsigned int x = 0; x < iw; ++x, ++pos) {
+                if (face.get_pixel(x, y)) out.data[pos >> 3] |= 1 << (pos & 7);
+            }
+        }
+    }
+    return out;
+}
+
 ///Run operation for specified character
 /**
  * @param font selected font
@@ -309,7 +896,7 @@ struct FontFaceSpec<FontFace<height,width> > {
  * @return
  */
 template<typename Font, typename Fn>
-auto do_for_character(const Font &font, int ascii_char, Fn &&fn) {
+constexpr auto do_for_character(const Font &font, int ascii_char, Fn &&fn) {
     if (ascii_char < 33) ascii_char = 32;
     else if (ascii_char > 127) ascii_char = '?';
     ascii_char -= 32;
@@ -318,6 +905,277 @@ auto do_for_character(const Font &font, int ascii_char, Fn &&fn) {
     return fn(Spec{chdef});
 }
 
+///Decode one character of UTF-8 string
+/**
+ * @param text text
+ * @param pos position in the text, it is moved after the decoded character
+ * @return code point of the character. Invalid sequence is returned as '?', this
+ * includes overlong forms, surrogates and code points above U+10FFFF
+ */
+constexpr int decode_utf8(std::string_view text, std::size_t &pos) {
+    unsigned int b = static_cast<uint8_t>(text[pos++]);
+    if (b < 0x80) return static_cast<int>(b);
+    unsigned int cont = 0;
+    //smallest code point which needs this length (shorter forms are overlong)
+    unsigned int min = 0;
+    if (b >= 0xF8) {
+        return '?';
+    } else if (b >= 0xF0) {
+        cont = 3;
+        min = 0x10000;
+        b &= 0x07;
+    } else if (b >= 0xE0) {
+        cont = 2;
+        min = 0x800;
+        b &= 0x0F;
+    } else if (b >= 0xC0) {
+        cont = 1;
+        min = 0x80;
+        b &= 0x1F;
+    } else {
+        return '?';
+    }
+    for (; cont; --cont) {
+        if (pos >= text.size() || (text[pos] & 0xC0) != 0x80) return '?';
+        b = (b << 6) | (text[pos++] & 0x3F);
+    }
+    //overlong forms, surrogates and code points beyond Unicode
+    if (b < min || (b >= 0xD800 && b < 0xE000) || b > 0x10FFFF) return '?';
+    return static_cast<int>(b);
+}
+
+///Glyph of a character outside of ASCII
+/**
+ * @tparam Face type of glyph of the base font (FontFace or FontFaceP)
+ */
+template<typename Face>
+struct ExtraGlyph {
+    ///code point
+    char32_t code;
+    ///glyph
+    Face face;
+};
+
+///Font extended by glyphs of selected non-ASCII characters
+/**
+ * Contains only glyphs, which are actually needed. They are sorted by code point
+ * at compile time, so the lookup is binary search. Characters not found are
+ * handled by the base font. Create the font by extend_font()
+ *
+ * @tparam Font type of base font (Font or FontP)
+ * @tparam N count of extra glyphs
+ */
+template<typename Font, std::size_t N>
+struct ExtendedFont {
+    using Face = std::decay_t<decltype(std::declval<const Font &>()[0])>;
+    ///base font
+    const Font *base;
+    ///sorted code points
+    char32_t codes[N] = {};
+    ///glyphs
+    Face glyphs[N] = {};
+
+    ///find glyph
+    /**
+     * @param code code point
+     * @return pointer to glyph, or nullptr if not found
+     */
+    constexpr const Face *find(char32_t code) const {
+        std::size_t l = 0;
+        std::size_t h = N;
+        while (l < h) {
+            std::size_t m = (l + h) / 2;
+            if (codes[m] < code) l = m + 1;
+            else if (codes[m] > code) h = m;
+            else return &glyphs[m];
+        }
+        return nullptr;
+    }
+};
+
+///Extend font by glyphs of non-ASCII characters
+/**
+ * @param base base font. It must be declared as constexpr variable, it is referenced
+ * @param glyphs list of extra glyphs
+ * @return ExtendedFont
+ *
+ * @code
+ * constexpr auto font_6p_cz = DotMatrix::extend_font(DotMatrix::font_6p, {
+ *    DotMatrix::ExtraGlyph<DotMatrix::FontFaceP<7,6> >{U'č', {5,
+ *        " x x  "
+ *        ...
+ * });
+ * @endcode
+ */
+template<typename Font, std::size_t N>
+constexpr auto extend_font(const Font &base,
+        const ExtraGlyph<std::decay_t<decltype(std::declval<const Font &>()[0])> > (&glyphs)[N]) {
+    ExtendedFont<Font, N> out = {&base};
+    for (std::size_t i = 0; i < N; ++i) {
+        std::size_t j = i;
+        while (j > 0 && out.codes[j - 1] > glyphs[i].code) {
+            out.codes[j] = out.codes[j - 1];
+            out.glyphs[j] = out.glyphs[j - 1];
+            --j;
+        }
+        out.codes[j] = glyphs[i].code;
+        out.glyphs[j] = glyphs[i].face;
+    }
+    return out;
+}
+
+///detects ExtendedFont
+template<typename T>
+struct IsExtendedFont : std::false_type {};
+
+template<typename Font, std::size_t N>
+struct IsExtendedFont<ExtendedFont<Font, N> > : std::true_type {};
+
+///height of glyphs of the font (of the base font for ExtendedFont)
+template<typename Font>
+struct FontHeight {
+    using Face = std::decay_t<decltype(std::declval<const Font &>()[0])>;
+    static constexpr int value = std::decay_t<decltype(std::declval<FontFaceSpec<Face> >().get_face())>::get_height();
+};
+
+template<typename Font, std::size_t N>
+struct FontHeight<ExtendedFont<Font, N> > : FontHeight<Font> {};
+
+///Run operation for specified character of extended font
+/**
+ * @param font extended font
+ * @param code code point of the character
+ * @param fn function called with FontFaceSpec containing the actual character face
+ * @return
+ */
+template<typename Font, std::size_t N, typename Fn>
+constexpr auto do_for_character(const ExtendedFont<Font, N> &font, int code, Fn &&fn) {
+    using Spec = FontFaceSpec<typename ExtendedFont<Font, N>::Face>;
+    if (code > 127) {
+        const auto *g = font.find(static_cast<char32_t>(code));
+        if (g) return fn(Spec{*g});
+    }
+    return do_for_character(*font.base, code, std::forward<Fn>(fn));
+}
+
+///Font with glyphs rotated at compile time
+/**
+ * Created by rotate_font(). TextRender with matching rotation renders
+ * glyphs of this font without rotation (row copy)
+ *
+ * @tparam rot rotation of glyphs
+ * @tparam height height of rotated glyph
+ * @tparam max_width width of rotated glyph
+ */
+template<Rotation rot, unsigned int height, unsigned int max_width>
+struct RotatedFont {
+    ///rotation of glyphs
+    static constexpr Rotation rotation = rot;
+    ///rotated glyphs, width contains advance of the original glyph
+    FontP<height, max_width> glyphs = {};
+
+    ///access glyph
+    constexpr const FontFaceP<height, max_width> &operator[](unsigned int idx) const {
+        return glyphs[idx];
+    }
+};
+
+///detects RotatedFont (also extended by extra glyphs), rotation contains the rotation of glyphs
+template<typename T>
+struct IsRotatedFont : std::false_type {};
+
+template<Rotation rot, unsigned int height, unsigned int max_width>
+struct IsRotatedFont<RotatedFont<rot, height, max_width> > : std::true_type {
+    static constexpr Rotation rotation = rot;
+};
+
+template<typename Font, std::size_t N>
+struct IsRotatedFont<ExtendedFont<Font, N> > : IsRotatedFont<Font> {};
+
+///rotate glyph into a glyph of RotatedFont
+template<Rotation rot, typename Spec, unsigned int height, unsigned int max_width>
+constexpr void rotate_glyph(const Spec &spec, FontFaceP<height, max_width> &g) {
+    const auto &face = spec.get_face();
+    using Face = std::decay_t<decltype(face)>;
+    constexpr unsigned int w = Face::get_width();
+    constexpr unsigned int h = Face::get_height();
+    g.width = spec.get_width();
+    for (unsigned int y = 0; y < h; ++y) {
+        for (unsigned int x = 0; x < w; ++x) {
+            if (!face.get_pixel(x, y)) continue;
+            if constexpr(rot == Rotation::rot90) {
+                g.face.set_pixel(h - 1 - y, x);
+            } else if constexpr(rot == Rotation::rot180) {
+                g.face.set_pixel(w - 1 - x, h - 1 - y);
+            } else if constexpr(rot == Rotation::rot270) {
+                g.face.set_pixel(y, w - 1 - x);
+            } else {
+                g.face.set_pixel(x, y);
+            }
+        }
+    }
+}
+
+///Rotate font at compile time
+/**
+ * @tparam rot rotation
+ * @param font source font (fixed, proportional or packed)
+ * @return RotatedFont
+ *
+ * @code
+ * constexpr auto font_6p_rot90 = DotMatrix::rotate_font<DotMatrix::Rotation::rot90>(DotMatrix::font_6p);
+ * @endcode
+ */
+template<Rotation rot, typename Font>
+constexpr auto rotate_font(const Font &font) {
+    using Spec = FontFaceSpec<std::decay_t<decltype(font[0])> >;
+    using Face = std::decay_t<decltype(Spec{font[0]}.get_face())>;
+    constexpr bool swap = rot == Rotation::rot90 || rot == Rotation::rot270;
+    constexpr unsigned int w = Face::get_width();
+    constexpr unsigned int h = Face::get_height();
+    RotatedFont<rot, swap?w:h, swap?h:w> out = {};
+    for (unsigned int i = 0; i < out.glyphs.size(); ++i) {
+        rotate_glyph<rot>(Spec{font[i]}, out.glyphs[i]);
+    }
+    return out;
+}
+
+template<Rotation rot, const auto &font>
+constexpr auto make_rotated_font();
+
+///Font rotated at compile time, instantiated once per font and rotation
+/**
+ * Unlike rotate_font(), it also rotates ExtendedFont (the base font and the extra glyphs).
+ * TextRender::render_text() with the font as template argument selects it automatically
+ *
+ * @tparam rot rotation
+ * @tparam font source font, declared as constexpr variable
+ *
+ * @code
+ * const auto &font = DotMatrix::rotated_font<DotMatrix::Rotation::rot90, DotMatrix::font_6p>;
+ * @endcode
+ */
+template<Rotation rot, const auto &font>
+inline constexpr auto rotated_font = make_rotated_font<rot, font>();
+
+template<Rotation rot, const auto &font>
+constexpr auto make_rotated_font() {
+    using Font = std::decay_t<decltype(font)>;
+    if constexpr(IsExtendedFont<Font>::value) {
+        const auto &base = rotated_font<rot, *font.base>;
+        using Base = std::decay_t<decltype(base)>;
+        constexpr std::size_t n = sizeof(font.codes) / sizeof(font.codes[0]);
+        ExtendedFont<Base, n> out = {&base};
+        for (std::size_t i = 0; i < n; ++i) {
+            out.codes[i] = font.codes[i];
+            rotate_glyph<rot>(FontFaceSpec<typename Font::Face>{font.glyphs[i]}, out.glyphs[i]);
+        }
+        return out;
+    } else {
+        return rotate_font<rot>(font);
+    }
+}
+
 ///Text renderer
 /**
  * @tparam op blit operation
@@ -326,6 +1184,9 @@ auto do_for_character(const Font &font, int ascii_char, Fn &&fn) {
 template<BltOp op = BltOp::copy, Rotation rot = Rotation::rot0>
 struct TextRender {
 
+    ///rotation of the text
+    static constexpr Rotation rotation = rot;
+
     ///render single character
     /**
      * @param fb frame buffer
@@ -337,12 +1198,29 @@ struct TextRender {
      * @return returns with of the character
      */
     template<typename FrameBuffer, typename Font>
-    static uint8_t render_character(FrameBuffer &fb, const Font &font,
+    static constexpr uint8_t render_character(FrameBuffer &fb, const Font &font,
             unsigned int x, unsigned int y, int ascii_char, const ColorMap &cols = {}) {
-        return do_for_character(font, ascii_char, [&](auto spec){
-            BitBlt<op, rot>::template bitblt(spec.get_face() ,fb, x, y, cols);
-            return spec.get_width();
-        });
+        if constexpr(IsRotatedFont<Font>::value) {
+            static_assert(IsRotatedFont<Font>::rotation == rot, "The font is rotated for different rotation");
+            return do_for_character(font, ascii_char, [&](auto spec){
+                const auto &face = spec.get_face();
+                int col = x;
+                int row = y;
+                if constexpr(rot == Rotation::rot90 || rot == Rotation::rot180) {
+                    col -= face.get_width() - 1;
+                }
+                if constexpr(rot == Rotation::rot180 || rot == Rotation::rot270) {
+                    row -= face.get_height() - 1;
+                }
+                BitBlt<op, Rotation::rot0>::template bitblt(face ,fb, col, row, cols);
+                return spec.get_width();
+            });
+        } else {
+            return do_for_character(font, ascii_char, [&](auto spec){
+                BitBlt<op, rot>::template bitblt(spec.get_face() ,fb, x, y, cols);
+                return spec.get_width();
+            });
+        }
     }
     ///retrieve with of the character
     /**
@@ -351,9 +1229,9 @@ struct TextRender {
      * @return width
      */
     template<typename Font>
-    static uint8_t get_character_width(const Font &font, int ascii_char) {
+    static constexpr uint8_t get_character_width(const Font &font, int ascii_char) {
         return do_for_character(font, ascii_char, [&](auto spec){
-            spec.get_width();
+            return spec.get_width();
         });
     }
 
@@ -363,15 +1241,16 @@ struct TextRender {
      * @param font font
      * @param x starting x coordinate (left top of first letter)
      * @param y starting y coordinate (left top of first letter)
-     * @param text string to render
+     * @param text string to render (UTF-8)
      * @param cols colors
      * @return new x and new y coordinate (to continue in rendering)
      */
     template<typename FrameBuffer, typename Font>
-    static std::pair<unsigned int, unsigned int> render_text(FrameBuffer &fb, const Font &font,
+    static constexpr std::pair<unsigned int, unsigned int> render_text(FrameBuffer &fb, const Font &font,
             unsigned int x, unsigned int y, std::string_view text, const ColorMap &cols = {}) {
-        for (char c: text) {
-            auto s = render_character(fb, font, x, y, c, cols);
+        std::size_t pos = 0;
+        while (pos < text.size()) {
+            auto s = render_character(fb, font, x, y, decode_utf8(text, pos), cols);
             if constexpr(rot == Rotation::rot0) {
                 x+=s;
             } else if constexpr(rot == Rotation::rot90) {
@@ -384,22 +1263,34 @@ struct TextRender {
         }
         return {x,y};
     }
-};
-
-template<typename T, T from, T to>
-struct ToIntergalValue {
-    template<typename Fn>
-    static constexpr  auto call(T val, Fn &&fn) {
-        if (val == from) return fn(std::integral_constant<T, from>());
-        else return ToIntergalValue<T, static_cast<T>(static_cast<int>(from)+1), to>::call(val, std::forward<Fn>(fn));
-    }
-};
 
-template<typename T, T x>
-struct ToIntergalValue<T, x, x> {
-    template<typename Fn>
-    static constexpr  auto call(T , Fn &&fn) {
-        return fn(std::integral_constant<T, x>());
+    ///render text, the font is pre-rotated for any rotation other than rot0
+    /**
+     * Glyphs of rotated text are copied without rotation at runtime, the font
+     * is rotated once at compile time (see rotated_font)
+     *
+     * @tparam font font declared as constexpr variable (not RotatedFont)
+     * @param fb frame buffer
+     * @param x starting x coordinate (left top of first letter)
+     * @param y starting y coordinate (left top of first letter)
+     * @param text string to render (UTF-8)
+     * @param cols colors
+     * @return new x and new y coordinate (to continue in rendering)
+     *
+     * @code
+     * DotMatrix::TextRender<DotMatrix::BltOp::copy, DotMatrix::Rotation::rot90>
+     *     ::render_text<DotMatrix::font_6p>(frame_buffer, 7, 0, "text");
+     * @endcode
+     */
+    template<const auto &font, typename FrameBuffer>
+    static constexpr std::pair<unsigned int, unsigned int> render_text(FrameBuffer &fb,
+            unsigned int x, unsigned int y, std::string_view text, const ColorMap &cols = {}) {
+        static_assert(!IsRotatedFont<std::decay_t<decltype(font)> >::value, "The font is already rotated");
+        if constexpr(rot != Rotation::rot0) {
+            return render_text(fb, rotated_font<rot, font>, x, y, text, cols);
+        } else {
+            return render_text(fb, font, x, y, text, cols);
+        }
     }
 };
 
@@ -407,14 +1298,7 @@ template<unsigned int w, unsigned int h>
 template<typename FrameBuffer>
 constexpr void Bitmap<w,h>::draw(FrameBuffer &fb, unsigned int x, unsigned int y, ColorMap colors,
         BltOp blt_op, Rotation r) const {
-    ToIntergalValue<BltOp, BltOp::copy, BltOp::copy_neg>
-        ::call(blt_op,[&](auto c_op){
-            ToIntergalValue<Rotation, Rotation::rot0, Rotation::rot270>
-                ::call(r, [&](auto r_op) {
-                    BitBlt<c_op.value, r_op.value>::bitblt(*this, fb, x, y, colors);
-                });
-        });
-
+    draw_bitmap(*this, fb, x, y, colors, blt_op, r);
 }
 
 
@@ -0,0 +1,218 @@
+#include <DotMatrix.h>
+
+//Measures cost of Driver::drive() for every format and orientation
+//Results are printed to Serial (115200 baud)
+//
+//cycles are measured by DWT->CYCCNT. Instruction count is estimated from
+//DWT profiling counters (CYCCNT - CPICNT - EXCCNT - SLEEPCNT - LSUCNT + FOLDCNT).
+//Profiling counters are 8 bit wide, so the estimate is valid while
+//each of them advances less than 256 per tick
+//
+//isr/s is average interrupt rate at recommended_refresh_freq (BCM formats
+//use ticks of different length, dimming adds blanking interrupt), cpu% is share
+//of CPU time spent in drive(). Exception entry/exit is not included
+
+using namespace DotMatrix;
+
+constexpr unsigned int bench_ticks = 4620;   //multiple of 11, 22, 33 and 44 - whole scans
+
+struct Result {
+    uint32_t min_cycles = ~uint32_t(0);
+    uint32_t max_cycles = 0;
+    uint32_t total_cycles = 0;
+    uint32_t total_instructions = 0;
+    uint32_t total_weight = 0;
+    uint32_t total_isr = 0;
+    unsigned int ticks = 0;
+    unsigned int freq = 0;
+};
+
+void enable_counters() {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk | DWT_CTRL_CPIEVTENA_Msk | DWT_CTRL_EXCEVTENA_Msk
+              | DWT_CTRL_SLEEPEVTENA_Msk | DWT_CTRL_LSUEVTENA_Msk | DWT_CTRL_FOLDEVTENA_Msk;
+}
+
+template<typename Fn>
+void measure_tick(Result &r, Fn &&fn) {
+    noInterrupts();
+    uint32_t cpi = DWT->CPICNT, exc = DWT->EXCCNT, slp = DWT->SLEEPCNT;
+    uint32_t lsu = DWT->LSUCNT, fold = DWT->FOLDCNT;
+    uint32_t start = DWT->CYCCNT;
+    fn();
+    uint32_t cycles = DWT->CYCCNT - start;
+    uint32_t stalls = ((DWT->CPICNT - cpi) & 0xFF) + ((DWT->EXCCNT - exc) & 0xFF)
+                    + ((DWT->SLEEPCNT - slp) & 0xFF) + ((DWT->LSUCNT - lsu) & 0xFF);
+    uint32_t folded = (DWT->FOLDCNT - fold) & 0xFF;
+    interrupts();
+    r.min_cycles = std::min(r.min_cycles, cycles);
+    r.max_cycles = std::max(r.max_cycles, cycles);
+    r.total_cycles += cycles;
+    r.total_instructions += cycles - stalls + folded;
+    ++r.ticks;
+}
+
+void print_result(const char *name, const Result &r) {
+    float ns_per_cycle = 1e9f / SystemCoreClock;
+    float isr_rate = static_cast<float>(r.freq) * r.total_isr / r.total_weight;
+    float cpu_load = 100.0f * r.total_cycles / r.ticks * isr_rate / SystemCoreClock;
+    char buff[140];
+    snprintf(buff, sizeof(buff), "%-28s %8.0f %8.0f %8.1f %8lu %8.1f %8.0f %6.2f",
+            name,
+            ns_per_cycle * r.total_cycles / r.ticks,
+            ns_per_cycle * r.max_cycles,
+            static_cast<float>(r.total_cycles) / r.ticks,
+            static_cast<unsigned long>(r.max_cycles),
+            static_cast<float>(r.total_instructions) / r.ticks,
+            isr_rate, cpu_load);
+    Serial.println(buff);
+}
+
+template<typename FrameBuffer>
+void fill_pattern(FrameBuffer &fb) {
+    uint32_t x = 0x12345678;
+    for (auto &p: fb.pixels) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        p = static_cast<uint8_t>(x);
+    }
+}
+
+template<typename FrameBuffer, Orientation orientation>
+void bench_driver(const char *name, unsigned int offset_step = 0, unsigned int px_step = 0) {
+    static FrameBuffer fb;
+    static constexpr Driver<FrameBuffer, orientation> driver = {};
+    State st = {};
+    Result r;
+    fill_pattern(fb);
+    for (unsigned int i = 0; i < bench_ticks; ++i) {
+        unsigned int offset = (i / 11) * offset_step;
+        unsigned int px_offset = (i / 11) * px_step;
+        measure_tick(r, [&]{driver.drive(st, fb, offset, px_offset);});
+        r.total_weight += driver.tick_weight(st.counter);
+        ++r.total_isr;
+    }
+    r.freq = FrameBuffer::recommended_refresh_freq;
+    print_result(name, r);
+}
+
+//drive two layers (scrolling text under HUD with mask)
+template<typename FrameBuffer, Orientation orientation>
+void bench_layers(const char *name) {
+    using TextFB = DotMatrix::FrameBuffer<FrameBuffer::width, FrameBuffer::height * 8, FrameBuffer::format, FrameBuffer::order>;
+    static TextFB text;
+    static FrameBuffer hud, mask;
+    static LayerStack<FrameBuffer, 2> layers;
+    static constexpr Driver<FrameBuffer, orientation> driver = {};
+    State st = {};
+    Result r;
+    fill_pattern(text);
+    fill_pattern(hud);
+    mask.draw_box(0, 0, FrameBuffer::width - 1, 1, 1);
+    layers.set(0, text);
+    layers.set_masked(1, hud, mask);
+    for (unsigned int i = 0; i < bench_ticks; ++i) {
+        layers.layers[0].fb_offset = i / 11;
+        measure_tick(r, [&]{driver.drive(st, layers);});
+        r.total_weight += driver.tick_weight(st.counter);
+        ++r.total_isr;
+    }
+    r.freq = FrameBuffer::recommended_refresh_freq;
+    print_result(name, r);
+}
+
+//decode of delta encoded animation, one frame per tick
+constexpr auto bench_anim_source = []{
+    std::array<AnimationFrame<FrameBuffer<12, 8> >, 16> out = {};
+    uint32_t x = 0x9E3779B9;
+    for (unsigned int f = 0; f < out.size(); ++f) {
+        out[f].duration = 20;
+        if (f) out[f].fb = out[f - 1].fb;
+        for (unsigned int i = 0; i < 8; ++i) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            out[f].fb.set_pixel(x % 12, (x >> 8) % 8, (x >> 16) & 1);
+        }
+    }
+    return out;
+}();
+constexpr auto bench_anim = encode_animation<bench_anim_source>();
+
+void bench_animation(const char *name) {
+    static FrameBuffer<12, 8> fb;
+    AnimationPlayer<decltype(bench_anim)> player(bench_anim);
+    Result r;
+    for (unsigned int i = 0; i < bench_ticks; ++i) {
+        measure_tick(r, [&]{player.decode_next(fb);});
+        r.total_weight += 1;
+    }
+    print_result(name, r);
+}
+
+//drive with global brightness - adjust_auto_drive() and blanking interrupt
+//are included in the tick. Auto drive runs an empty function to have the timer
+template<typename FrameBuffer, Orientation orientation>
+void bench_brightness(const char *name, uint8_t brightness) {
+    static FrameBuffer fb;
+    static constexpr Driver<FrameBuffer, orientation> driver = {};
+    State st = {};
+    st.brightness = brightness;
+    Result r;
+    fill_pattern(fb);
+    enable_auto_drive([]{}, FrameBuffer::recommended_refresh_freq);
+    bool blanking = brightness != 0 && gamma_table.dwell[brightness] != GammaTable::full_dwell;
+    for (unsigned int i = 0; i < bench_ticks; ++i) {
+        measure_tick(r, [&]{
+            driver.drive(st, fb);
+            driver.adjust_auto_drive(st);
+            if (blanking) DirectDrive::clear_matrix();
+        });
+        r.total_weight += driver.tick_weight(st.counter);
+        r.total_isr += blanking?2:1;
+    }
+    disable_auto_drive();
+    r.freq = FrameBuffer::recommended_refresh_freq;
+    print_result(name, r);
+}
+
+template<Format format>
+void bench_format(const char *fmt_name) {
+    using Landscape = FrameBuffer<12, 8, format>;
+    using Portrait = FrameBuffer<8, 12, format>;
+    char name[40];
+    snprintf(name, sizeof(name), "%s landscape", fmt_name);
+    bench_driver<Landscape, Orientation::landscape>(name);
+    snprintf(name, sizeof(name), "%s portrait", fmt_name);
+    bench_driver<Portrait, Orientation::portrait>(name);
+    snprintf(name, sizeof(name), "%s rev_landscape", fmt_name);
+    bench_driver<Landscape, Orientation::reverse_landscape>(name);
+    snprintf(name, sizeof(name), "%s rev_portrait", fmt_name);
+    bench_driver<Portrait, Orientation::reverse_portrait>(name);
+}
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {}
+    enable_counters();
+    Serial.println("case                          ns/tick  worst ns cyc/tick worst cy instr/tk    isr/s   cpu%");
+    bench_format<Format::monochrome_1bit>("mono");
+    bench_format<Format::gray_blink_2bit>("gray");
+    bench_format<Format::gray_bcm_3bit>("bcm3");
+    bench_format<Format::gray_bcm_4bit>("bcm4");
+    //virtual screens (examples/textscroll) with nonzero fb_offset
+    bench_driver<FrameBuffer<8, 96*6>, Orientation::portrait>("mono 8x576 scroll", 1);
+    bench_driver<FrameBuffer<8, 96*3, Format::gray_blink_2bit>, Orientation::portrait>("gray 8x288 scroll", 2);
+    bench_driver<FrameBuffer<96, 8>, Orientation::landscape>("mono 96x8 scroll", 1);
+    //pixel offset uses generic (not unrolled) path
+    bench_driver<FrameBuffer<96, 8>, Orientation::landscape>("mono 96x8 px scroll", 0, 1);
+    //layers
+    bench_layers<FrameBuffer<8, 12>, Orientation::portrait>("mono 2 layers");
+    bench_layers<FrameBuffer<8, 12, Format::gray_blink_2bit>, Orientation::portrait>("gray 2 layers");
+    //animation decode (isr/s and cpu% are not relevant)
+    bench_animation("animation decode 12x8");
+    //global brightness
+    bench_brightness<FrameBuffer<12, 8>, Orientation::landscape>("mono brightness 255", 255);
+    bench_brightness<FrameBuffer<12, 8>, Orientation::landscape>("mono brightness 128", 128);
+    bench_brightness<FrameBuffer<12, 8, Format::gray_bcm_4bit>, Orientation::landscape>("bcm4 brightness 128", 128);
+}
+
+void loop() {
+}
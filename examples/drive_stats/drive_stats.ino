@@ -0,0 +1,40 @@
+#include <DotMatrix.h>
+
+//Prints timing of the auto drive interrupt every second: duration of the
+//tick, achieved frequency, CPU load and ticks missed because other interrupts
+//delayed the timer
+
+using MyFB =  DotMatrix::FrameBuffer<12, 8, DotMatrix::Format::gray_bcm_4bit>;
+using MyDriver = DotMatrix::Driver<MyFB, DotMatrix::Orientation::landscape>;
+
+MyFB fb;
+constexpr MyDriver driver = {};
+DotMatrix::State st = {};
+DotMatrix::DriveStatsRecorder recorder;
+
+void setup() {
+  Serial.begin(115200);
+  for (unsigned int x = 0; x < 12; ++x) fb.draw_box(x, 0, x, 7, x + 4);
+  DotMatrix::enable_auto_drive(driver, st, fb);
+  DotMatrix::set_auto_drive_stats(&recorder);
+}
+
+void loop() {
+  delay(1000);
+  DotMatrix::DriveStats s;
+  if (!recorder.snapshot(s)) return;
+  auto ns = [&](uint32_t cycles) {
+    return static_cast<unsigned long>(1000000000ULL * cycles / s.counter_freq);
+  };
+  char buf[128];
+  snprintf(buf, sizeof(buf), "ticks %lu, min %lu ns, mean %lu ns, max %lu ns, %lu Hz, cpu %lu.%lu%%, missed %lu",
+           s.ticks,
+           ns(s.min_cycles),
+           ns(s.mean_cycles()),
+           ns(s.max_cycles),
+           static_cast<unsigned long>(s.tick_freq()),
+           static_cast<unsigned long>(s.cpu_load_permille() / 10),
+           static_cast<unsigned long>(s.cpu_load_permille() % 10),
+           s.missed_ticks);
+  Serial.println(buf);
+}
@@ -0,0 +1,29 @@
+#include <DotMatrix.h>
+
+//Frames are rendered ahead and queued with their durations. The interrupt
+//displays them for exactly 100 ms each, even when loop() is late
+
+using MyFB =  DotMatrix::FrameBuffer<12, 8, DotMatrix::Format::monochrome_1bit>;
+using MyDriver = DotMatrix::Driver<MyFB, DotMatrix::Orientation::landscape>;
+using MyQueue = DotMatrix::FrameQueue<MyFB, 4, DotMatrix::QueuePolicy::hold_last>;
+
+MyQueue queue;
+constexpr MyDriver driver = {};
+DotMatrix::State st = {};
+
+int x = 0, dx = 1;
+
+void setup() {
+  DotMatrix::enable_auto_drive(driver, st, queue);
+}
+
+void loop() {
+  MyFB *fb = queue.acquire();
+  if (fb == nullptr) return;    //queue is full, try later
+  fb->clear();
+  fb->draw_box(x, 2, x, 5, 1);
+  queue.push(MyQueue::ticks_from_ms(100));
+  x += dx;
+  if (x <= 0 || x >= 11) dx = -dx;
+  delay(random(0, 150));        //jittering producer
+}
@@ -0,0 +1,35 @@
+#include <DotMatrix.h>
+
+//Scrolling text (bottom layer) with static HUD on top. The HUD is never
+//re-rendered, scrolling is only change of the layer offset
+
+using TextFB =  DotMatrix::FrameBuffer<8, 96*2, DotMatrix::Format::monochrome_1bit>;
+using HudFB =  DotMatrix::FrameBuffer<8, 12, DotMatrix::Format::monochrome_1bit>;
+using MyDriver = DotMatrix::Driver<HudFB, DotMatrix::Orientation::portrait>;
+
+TextFB text;
+HudFB hud;
+HudFB hud_mask;
+DotMatrix::LayerStack<HudFB, 2> layers;
+constexpr MyDriver driver = {};
+DotMatrix::State st = {};
+
+
+void setup() {
+  DotMatrix::TextRender<DotMatrix::BltOp::copy, DotMatrix::Rotation::rot90>
+      ::render_text<DotMatrix::font_6p>(text, 7, 0, "Hello world! Layers are combined by the driver ");
+  //HUD: two rows at the right edge, the mask makes it opaque
+  hud.draw_box(0, 0, 7, 1, 0);
+  hud.draw_box(1, 0, 6, 0, 1);
+  hud_mask.draw_box(0, 0, 7, 1, 1);
+  layers.set(0, text);
+  layers.set_masked(1, hud, hud_mask);
+  DotMatrix::enable_auto_drive(driver, st, layers);
+  //scroll 20 times per second by the auto drive timer
+  DotMatrix::schedule_task([]{
+    layers.layers[0].fb_offset = (layers.layers[0].fb_offset + 1) % TextFB::count_bytes;
+  }, 0, HudFB::recommended_refresh_freq / 20);
+}
+
+void loop() {
+}
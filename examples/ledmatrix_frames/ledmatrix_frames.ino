@@ -0,0 +1,35 @@
+#include <DotMatrix.h>
+
+//Plays frames in format of Arduino_LED_Matrix directly from flash
+//(3 words of pixels + duration), no frame buffer is needed
+
+constexpr uint32_t frames[][4] = {
+  {0xe0000000, 0x0, 0x0, 66},
+  {0x400e0000, 0x0, 0x0, 66},
+  {0x400e0, 0x0, 0x0, 66},
+  {0x40, 0xe000000, 0x0, 66},
+  {0x3000000, 0x400e000, 0x0, 66},
+  {0x3003000, 0x400e, 0x0, 66},
+  {0x3003, 0x4, 0xe00000, 66},
+  {0x3, 0x300000, 0x400e00, 66},
+  {0x0, 0x300300, 0x400e00, 66},
+  {0x0, 0x0, 0x0, 500},
+};
+
+constexpr unsigned int count_frames = sizeof(frames)/sizeof(frames[0]);
+using MyDriver = DotMatrix::Driver<DotMatrix::LedMatrixFrame, DotMatrix::Orientation::landscape>;
+
+constexpr MyDriver driver = {};
+DotMatrix::State st = {};
+DotMatrix::LedMatrixFrame view(frames[0]);
+unsigned int frame = 0;
+
+void setup() {
+  DotMatrix::enable_auto_drive(driver, st, view);
+}
+
+void loop() {
+  delay(frames[frame][3]);
+  frame = (frame + 1) % count_frames;
+  view.set(frames[frame]);
+}
@@ -0,0 +1,24 @@
+#include <DotMatrix.h>
+
+//16 rows ring buffer (16 bytes) instead of a frame buffer for whole text
+using MyFB =  DotMatrix::FrameBuffer<8, 16, DotMatrix::Format::monochrome_1bit>;
+using MyDriver = DotMatrix::Driver<MyFB, DotMatrix::Orientation::portrait>;
+using MyMarquee = DotMatrix::MarqueeRenderer<MyFB, std::decay_t<decltype(DotMatrix::font_6p)> >;
+
+constexpr unsigned int speed_div = 50;
+
+MyFB myfb;
+constexpr MyDriver driver = {};
+DotMatrix::State st = {};
+MyMarquee marquee(myfb, DotMatrix::font_6p, 7);
+DotMatrix::MarqueeText text = {"The text can be arbitrarily long, because only few rows are rendered ahead. "};
+
+void setup() {
+  marquee.update(0, text);
+  DotMatrix::enable_auto_drive_scroll(driver, st, myfb, speed_div);
+}
+
+void loop() {
+  marquee.update(st.counter / speed_div, text);
+  delay(10);
+}
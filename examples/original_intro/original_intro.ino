@@ -351,28 +351,22 @@ constexpr uint32_t frames[][4] = {
   }
 };
 
-constexpr unsigned int count_frames = sizeof(frames)/sizeof(frames[0]);
-using MyFB =  DotMatrix::FrameBuffer<12, count_frames * 8, DotMatrix::Format::monochrome_1bit, DotMatrix::Order::lsb_to_msb>;
+using MyFB =  DotMatrix::FrameBuffer<12, 8, DotMatrix::Format::monochrome_1bit>;
 using MyDriver = DotMatrix::Driver<MyFB, DotMatrix::Orientation::landscape>;
-MyFB fb;
+
+//raw frames are used only by the compiler, flash contains delta encoded animation
+constexpr auto source = DotMatrix::frames_from_words<MyFB>(frames);
+constexpr auto intro = DotMatrix::encode_animation<source>();
+
+DotMatrix::SwapChain<MyFB, 2> chain;
 DotMatrix::State st;
 constexpr MyDriver drv = {};
+DotMatrix::AnimationPlayer<decltype(intro)> player(intro);
 
 void setup() {
-  unsigned int z = 0;
-  for (const auto &x: frames) {
-    for (int i = 0; i<3; ++i) {
-      for (int j = 0;j<4; ++j) {  //animation has different format - convert it now
-        uint8_t p1 = (x[i] >> (8*(3-j))) & 0xFF;
-        fb.pixels[z] = p1;
-        ++z;
-      }
-    }
-  }
+  DotMatrix::enable_auto_drive(drv, st, chain);
 }
 
 void loop() {
-    drv.drive(st, fb, (st.counter/50)*12);
-    delay(2);
+  player.update(st, chain);
 }
-
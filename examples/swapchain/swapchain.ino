@@ -0,0 +1,27 @@
+#include <DotMatrix.h>
+
+using MyFB =  DotMatrix::FrameBuffer<12, 8, DotMatrix::Format::monochrome_1bit>;
+using MyDriver = DotMatrix::Driver<MyFB, DotMatrix::Orientation::landscape>;
+
+DotMatrix::SwapChain<MyFB, 3> chain;
+constexpr MyDriver driver = {};
+DotMatrix::State st = {};
+
+int x = 0, y = 0, dx = 1, dy = 1;
+
+void setup() {
+  DotMatrix::enable_auto_drive(driver, st, chain);
+}
+
+void loop() {
+  MyFB &fb = chain.back();
+  fb.clear();
+  fb.draw_box(0, 0, 11, 0, 1);
+  fb.draw_box(0, 7, 11, 7, 1);
+  fb.draw_box(x, y, x + 1, y + 1, 1);
+  chain.present();
+  x += dx; y += dy;
+  if (x <= 0 || x >= 10) dx = -dx;
+  if (y <= 1 || y >= 5) dy = -dy;
+  delay(80);
+}
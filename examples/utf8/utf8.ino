@@ -0,0 +1,85 @@
+#include <DotMatrix.h>
+
+using MyFB =  DotMatrix::FrameBuffer<8, 300, DotMatrix::Format::monochrome_1bit>;
+using MyDriver = DotMatrix::Driver<MyFB, DotMatrix::Orientation::portrait>;
+using Glyph = DotMatrix::ExtraGlyph<DotMatrix::FontFaceP<7, 6> >;
+
+//only characters used in the text are added
+constexpr auto font_6p_ext = DotMatrix::extend_font(DotMatrix::font_6p, {
+    Glyph{U'ř', {5, " x x  "
+                    "  x   "
+                    " xxx  "
+                    "x     "
+                    "x     "
+                    "x     "
+                    "      "}},
+    Glyph{U'ž', {5, " x x  "
+                    "  x   "
+                    "xxxx  "
+                    "  x   "
+                    " x    "
+                    "xxxx  "
+                    "      "}},
+    Glyph{U'á', {5, "   x  "
+                    "  x   "
+                    " xx   "
+                    "  xx  "
+                    "xx x  "
+                    " xxx  "
+                    "      "}},
+    Glyph{U'č', {5, " x x  "
+                    "  x   "
+                    " xxx  "
+                    "x     "
+                    "x     "
+                    " xxx  "
+                    "      "}},
+    Glyph{U'í', {4, "  x   "
+                    " x    "
+                    "xx    "
+                    " x    "
+                    " x    "
+                    "xxx   "
+                    "      "}},
+    Glyph{U'ů', {6, " xx   "
+                    " xx   "
+                    "x  x  "
+                    "x  x  "
+                    "x  x  "
+                    " xx   "
+                    "      "}},
+    Glyph{U'ä', {5, "x  x  "
+                    "      "
+                    " xx   "
+                    "  xx  "
+                    "xx x  "
+                    " xxx  "
+                    "      "}},
+    Glyph{U'ö', {5, "x  x  "
+                    "      "
+                    " xx   "
+                    "x  x  "
+                    "x  x  "
+                    " xx   "
+                    "      "}},
+    Glyph{U'ü', {6, "x  x  "
+                    "      "
+                    "x  x  "
+                    "x  x  "
+                    "x  x  "
+                    " xx   "
+                    "      "}},
+});
+
+MyFB myfb;
+constexpr MyDriver driver = {};
+DotMatrix::State st = {};
+
+void setup() {
+    DotMatrix::TextRender<DotMatrix::BltOp::copy, DotMatrix::Rotation::rot90>
+      ::render_text<font_6p_ext>(myfb, 7, 12, "řeka, žába, čísla, můj. Grün, schön, Bär");
+    DotMatrix::enable_auto_drive_scroll(driver, st, myfb, 50);
+}
+
+void loop() {
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+namespace DotMatrix {
+
+///What FrameQueue does when the current frame expires and more frames are queued
+/**
+ * The policy is applied by the consumer. When the queue is full, the producer
+ * is refused with both policies (acquire() returns nullptr), queued frames are
+ * never overwritten
+ */
+enum class QueuePolicy {
+    ///display every queued frame in order for its duration, the last frame is held
+    hold_last,
+    ///skip to the newest queued frame, older queued frames are never displayed
+    skip_to_newest
+};
+
+///Single producer single consumer queue of timed frames
+/**
+ * The main loop (producer) renders into acquire() and queues the frame by push()
+ * with its duration. The auto drive interrupt (consumer) displays front() and
+ * advances to the next frame at the end of the scan when the duration of
+ * the current frame has elapsed. Frames are paced by State::counter, so late
+ * or jittering loop() doesn't change durations of frames already queued.
+ * When the queue runs empty the last frame stays displayed, the next frame
+ * is displayed at the end of the scan in which it arrived.
+ *
+ * Neither side waits or disables interrupts. Each index is written by one side
+ * only. When the queue is full, acquire() returns nullptr and the producer
+ * decides whether to retry or to skip the frame.
+ *
+ * @tparam FrameBuffer type of frame buffer
+ * @tparam N count of buffers, one is displayed, at most N-1 frames are queued
+ * @tparam policy what to do with frames queued behind the expired frame
+ */
+template<typename FrameBuffer, unsigned int N, QueuePolicy policy = QueuePolicy::hold_last>
+class FrameQueue {
+public:
+
+    static_assert(N >= 2, "At least two buffers are required");
+    static_assert(N < 255, "Too many buffers");
+
+    ///count of State::counter ticks per second
+    static constexpr unsigned int ticks_per_second = FrameBuffer::recommended_refresh_freq
+            * (FrameBuffer::bcm_bits?FrameBuffer::bcm_bits:1)
+            / (FrameBuffer::bcm_bits?(1U << FrameBuffer::bcm_bits) - 1:1);
+
+    ///convert milliseconds to ticks of State::counter
+    static constexpr unsigned int ticks_from_ms(unsigned int ms) {
+        return static_cast<unsigned int>(static_cast<unsigned long long>(ms) * ticks_per_second / 1000);
+    }
+
+    ///retrieve buffer for the next frame (producer)
+    /**
+     * @return pointer to buffer, or nullptr if the queue is full. Content of
+     * the buffer is undefined, it contains some older frame
+     */
+    FrameBuffer *acquire() {
+        uint8_t t = _tail.load(std::memory_order_relaxed);
+        if (t == _front.load(std::memory_order_acquire)) return nullptr;
+        return &_buffers[t];
+    }
+
+    ///queue the frame rendered into acquire() (producer)
+    /**
+     * @param duration minimal duration of the frame in ticks of State::counter
+     * (see ticks_from_ms()). The frame stays displayed longer when no next frame is queued
+     * @retval true queued
+     * @retval false queue is full
+     */
+    bool push(unsigned int duration) {
+        uint8_t t = _tail.load(std::memory_order_relaxed);
+        if (t == _front.load(std::memory_order_acquire)) return false;
+        _durations[t] = duration;
+        _tail.store(next(t), std::memory_order_release);
+        return true;
+    }
+
+    ///count of queued frames, displayed frame is not included
+    unsigned int pending() const {
+        return (_tail.load() + N - _front.load() - 1) % N;
+    }
+
+    ///test whether acquire() would fail
+    bool full() const {
+        return _tail.load() == _front.load();
+    }
+
+    ///retrieve displayed frame (consumer)
+    const FrameBuffer &front() const {
+        return _buffers[_front.load(std::memory_order_relaxed)];
+    }
+
+    ///advance to the next frame if the current expired (consumer)
+    /**
+     * Must be called after the driver finished the scan, see Driver::scan_complete()
+     *
+     * @param counter State::counter
+     * @retval true new frame is displayed
+     * @retval false no change
+     */
+    bool advance(unsigned int counter) {
+        uint8_t f = _front.load(std::memory_order_relaxed);
+        uint8_t t = _tail.load(std::memory_order_acquire);
+        uint8_t n = next(f);
+        if (counter - _start < _duration) return false;
+        if (n == t) {
+            //underrun, next frame starts when it arrives
+            _late = true;
+            return false;
+        }
+        if constexpr(policy == QueuePolicy::skip_to_newest) {
+            n = t == 0?N - 1:t - 1;
+        }
+        if (_late) {
+            _start = counter;
+            _late = false;
+        } else {
+            _start += _duration;
+        }
+        _duration = _durations[n];
+        _front.store(n, std::memory_order_release);
+        return true;
+    }
+
+protected:
+    static constexpr uint8_t next(uint8_t i) {
+        return i + 1 == N?0:i + 1;
+    }
+
+    FrameBuffer _buffers[N] = {};
+    unsigned int _durations[N] = {};
+    ///displayed buffer, written by consumer
+    std::atomic<uint8_t> _front = {0};
+    ///buffer for the next frame, written by producer
+    std::atomic<uint8_t> _tail = {1};
+    ///consumer: start and duration of displayed frame
+    unsigned int _start = 0;
+    unsigned int _duration = 0;
+    bool _late = true;
+};
+
+///Enables automatic driving of a frame queue (using timer and interrupt)
+/**
+ * @param driver reference to driver
+ * @param st reference to state variable
+ * @param queue reference to frame queue. Frames are advanced at the end of the scan
+ */
+template<typename FrameBuffer, Orientation _orientation, int _offset, unsigned int N, QueuePolicy policy>
+void enable_auto_drive(const Driver<FrameBuffer, _orientation, _offset> &driver,
+         State &st, FrameQueue<FrameBuffer, N, policy> &queue) {
+
+    enable_auto_drive([&driver, &st, &queue]{
+        driver.drive(st, queue.front());
+        driver.adjust_auto_drive(st);
+        if (driver.scan_complete(st)) queue.advance(st.counter);
+    }, FrameBuffer::recommended_refresh_freq);
+}
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+namespace DotMatrix {
+
+///Timing statistics of driving
+/**
+ * Times are in cycles of read_cycle_counter(), see counter_freq
+ */
+struct DriveStats {
+    ///count of measured ticks
+    unsigned long ticks = 0;
+    ///shortest and longest tick
+    uint32_t min_cycles = ~uint32_t(0);
+    uint32_t max_cycles = 0;
+    ///sum of durations of ticks
+    unsigned long long total_cycles = 0;
+    ///sum of intervals between starts of ticks
+    unsigned long long elapsed_cycles = 0;
+    ///ticks which didn't happen because the interrupt was delayed (by 1.5 period or more)
+    unsigned long missed_ticks = 0;
+    ///frequency of the cycle counter
+    uint32_t counter_freq = 0;
+
+    ///mean duration of the tick in cycles
+    uint32_t mean_cycles() const {
+        return ticks?static_cast<uint32_t>(total_cycles / ticks):0;
+    }
+
+    ///achieved frequency of ticks in Hz
+    uint32_t tick_freq() const {
+        return elapsed_cycles?static_cast<uint32_t>(
+                static_cast<unsigned long long>(ticks) * counter_freq / elapsed_cycles):0;
+    }
+
+    ///part of the CPU taken by ticks in 1/1000
+    uint32_t cpu_load_permille() const {
+        return elapsed_cycles?static_cast<uint32_t>(total_cycles * 1000 / elapsed_cycles):0;
+    }
+};
+
+///Records timing of ticks
+/**
+ * The interrupt records into a live block. The main loop requests a snapshot,
+ * the interrupt publishes the live block at the next tick and starts a new one.
+ * Neither side waits or disables interrupts.
+ *
+ * Install it by set_auto_drive_stats(), or call measure() around the driver
+ * when driving from loop()
+ */
+class DriveStatsRecorder {
+public:
+
+    ///measure a tick (interrupt)
+    /**
+     * @param expected expected interval since the previous tick in cycles (0 - unknown,
+     * missed ticks are not counted)
+     * @param fn function to measure
+     */
+    template<typename Fn>
+    void measure(uint32_t expected, Fn &&fn) {
+        uint32_t start = read_cycle_counter();
+        fn();
+        uint32_t end = read_cycle_counter();
+        record(end - start, _started?start - _last_start:0, expected);
+        _last_start = start;
+        _started = true;
+    }
+
+    ///record a tick (interrupt)
+    /**
+     * @param cycles duration of the tick
+     * @param interval interval since the previous tick (0 - first tick)
+     * @param expected expected interval (0 - unknown)
+     */
+    void record(uint32_t cycles, uint32_t interval, uint32_t expected) {
+        DriveStats &s = _live;
+        ++s.ticks;
+        s.min_cycles = std::min(s.min_cycles, cycles);
+        s.max_cycles = std::max(s.max_cycles, cycles);
+        s.total_cycles += cycles;
+        if (interval) {
+            s.elapsed_cycles += interval;
+            if (expected && interval >= expected + expected / 2) {
+                s.missed_ticks += (interval + expected / 2) / expected - 1;
+            }
+        }
+        if (_request.load(std::memory_order_relaxed) && !_ready.load(std::memory_order_relaxed)) {
+            s.counter_freq = cycle_counter_freq();
+            _published = s;
+            _live = {};
+            _request.store(false, std::memory_order_relaxed);
+            _ready.store(true, std::memory_order_release);
+        }
+    }
+
+    ///retrieve statistics since the previous snapshot and reset them (main loop)
+    /**
+     * @param out statistics
+     * @retval true statistics retrieved
+     * @retval false not available yet, the interrupt publishes them at the next tick
+     */
+    bool snapshot(DriveStats &out) {
+        bool ok = _ready.load(std::memory_order_acquire);
+        if (ok) {
+            out = _published;
+            _ready.store(false, std::memory_order_relaxed);
+        }
+        _request.store(true, std::memory_order_release);
+        return ok;
+    }
+
+protected:
+    DriveStats _live = {};
+    DriveStats _published = {};
+    std::atomic<bool> _request = {false};
+    std::atomic<bool> _ready = {false};
+    uint32_t _last_start = 0;
+    bool _started = false;
+};
+
+}
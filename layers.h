@@ -0,0 +1,113 @@
+#pragma once
+namespace DotMatrix {
+
+///One layer of LayerStack
+/**
+ * The layer refers pixels of a frame buffer, it doesn't own them
+ */
+struct Layer {
+    ///pixels of the frame buffer (nullptr - layer is not used)
+    const uint8_t *pixels = nullptr;
+    ///pixels of the mask frame buffer for LayerOp::overwrite (nullptr - no mask)
+    const uint8_t *mask = nullptr;
+    ///size of the frame buffer in bytes (offsets wraps at this size)
+    unsigned int count_bytes = 0;
+    ///combine operation. It is ignored for the first layer
+    LayerOp op = LayerOp::overwrite;
+    ///offset in frame buffer in bytes, see Driver::drive()
+    unsigned int fb_offset = 0;
+    ///offset in frame buffer in pixels, see Driver::drive()
+    unsigned int px_offset = 0;
+};
+
+///Fixed stack of layers combined by the driver
+/**
+ * Layers are combined per pixel while the driver reads them, so the main loop
+ * never composes frames. Scrolling of a layer is change of its fb_offset or px_offset.
+ * Layer 0 is the bottom layer.
+ *
+ * All layers must have same width, format and order as the FrameBuffer, the height
+ * can differ (for example, a long scrolling text and a static HUD).
+ *
+ * @tparam FrameBuffer type of frame buffer of the driver
+ * @tparam N maximum count of layers
+ */
+template<typename FrameBuffer, unsigned int N>
+struct LayerStack {
+
+    static_assert(N > 0, "At least one layer is required");
+
+    ///count of layers
+    static constexpr unsigned int count = N;
+
+    ///layers, you can change offsets directly
+    Layer layers[N] = {};
+
+    ///set layer
+    /**
+     * @param index index of layer (0 - bottom)
+     * @param fb frame buffer. It must stay valid while the stack is displayed
+     * @param op combine operation
+     * @param fb_offset offset in bytes
+     * @param px_offset offset in pixels
+     */
+    template<typename LayerFB>
+    constexpr void set(unsigned int index, const LayerFB &fb, LayerOp op = LayerOp::overwrite,
+            unsigned int fb_offset = 0, unsigned int px_offset = 0) {
+        check_compatible<LayerFB>();
+        Layer &l = layers[index];
+        l.pixels = fb.pixels;
+        l.mask = nullptr;
+        l.count_bytes = LayerFB::count_bytes;
+        l.op = op;
+        l.fb_offset = fb_offset;
+        l.px_offset = px_offset;
+    }
+
+    ///set layer which overwrites pixels where the mask is non zero
+    /**
+     * @param index index of layer
+     * @param fb frame buffer
+     * @param mask mask frame buffer, it has the same type as fb, it uses
+     * the same offsets
+     * @param fb_offset offset in bytes
+     * @param px_offset offset in pixels
+     */
+    template<typename LayerFB>
+    constexpr void set_masked(unsigned int index, const LayerFB &fb, const LayerFB &mask,
+            unsigned int fb_offset = 0, unsigned int px_offset = 0) {
+        set(index, fb, LayerOp::overwrite, fb_offset, px_offset);
+        layers[index].mask = mask.pixels;
+    }
+
+    ///disable layer
+    constexpr void reset(unsigned int index) {
+        layers[index] = {};
+    }
+
+protected:
+    template<typename LayerFB>
+    static constexpr void check_compatible() {
+        static_assert(LayerFB::width == FrameBuffer::width, "Layer must have the same width");
+        static_assert(LayerFB::format == FrameBuffer::format, "Layer must have the same format");
+        static_assert(LayerFB::order == FrameBuffer::order, "Layer must have the same order");
+        static_assert(LayerFB::byte_swizzle == FrameBuffer::byte_swizzle, "Layer must have the same byte layout");
+    }
+};
+
+///Enables automatic driving of the layer stack
+/**
+ * @param driver driver instance
+ * @param st state
+ * @param layers layer stack
+ */
+template<typename FrameBuffer, Orientation _orientation, int _offset, unsigned int N>
+void enable_auto_drive(const Driver<FrameBuffer, _orientation, _offset> &driver,
+         State &st, const LayerStack<FrameBuffer, N> &layers) {
+    enable_auto_drive([&driver, &st, &layers]{
+        driver.drive(st, layers);
+        driver.adjust_auto_drive(st);
+    }, FrameBuffer::recommended_refresh_freq);
+}
+
+}
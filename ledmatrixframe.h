@@ -0,0 +1,71 @@
+#pragma once
+namespace DotMatrix {
+
+///View of a frame in format of Arduino_LED_Matrix
+/**
+ * The frame is 3 words (uint32_t), 96 pixels row-major, the first pixel is the bit 31
+ * of the first word. The view can be used with Driver instead of a FrameBuffer,
+ * the driver reads pixels directly from the words (which can be in flash). No copy or
+ * conversion is needed.
+ *
+ * Words are stored little endian, so the driver reads bytes in order 3,2,1,0,7,6,...
+ * (byte_swizzle) and pixels from MSB (Order::lsb_to_msb)
+ *
+ * @code
+ * constexpr DotMatrix::Driver<DotMatrix::LedMatrixFrame, DotMatrix::Orientation::landscape> driver = {};
+ * DotMatrix::LedMatrixFrame view(frames[0]);
+ * DotMatrix::enable_auto_drive(driver, st, view);
+ * ...
+ * view.set(frames[i]);
+ * @endcode
+ */
+struct LedMatrixFrame {
+    static constexpr unsigned int width = 12;
+    static constexpr unsigned int height = 8;
+    static constexpr Format format = Format::monochrome_1bit;
+    static constexpr Order order = Order::lsb_to_msb;
+    static constexpr uint8_t bits_per_pixel = 1;
+    static constexpr uint8_t bcm_bits = 0;
+    static constexpr unsigned int recommended_refresh_freq = 500;
+    static constexpr unsigned int count_pixels = width*height;
+    static constexpr unsigned int whole_frame = 12*width;
+    static constexpr unsigned int count_bytes = 12;
+    static constexpr uint8_t mask = 1;
+    static constexpr unsigned int byte_swizzle = 3;
+
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Little endian is required");
+
+    ///pixels - bytes of the words
+    const uint8_t *pixels = nullptr;
+
+    ///construct empty view
+    constexpr LedMatrixFrame() = default;
+    ///construct view
+    /**
+     * @param words pointer to words of the frame. At least 3 words, frames with duration (4 words)
+     * can be used directly
+     */
+    LedMatrixFrame(const uint32_t *words):pixels(reinterpret_cast<const uint8_t *>(words)) {}
+
+    ///change displayed frame
+    /**
+     * @param words pointer to words of the frame
+     *
+     * @note it can be called while auto drive is active, the pointer is stored by single write
+     */
+    void set(const uint32_t *words) {
+        pixels = reinterpret_cast<const uint8_t *>(words);
+    }
+
+    ///retrieve pixel value
+    uint8_t get_pixel(unsigned int x, unsigned int y) const {
+        if (x < width && y < height) {
+            unsigned int i = x + y * width;
+            return (pixels[(i / 8) ^ byte_swizzle] >> (7 - i % 8)) & 1;
+        } else {
+            return {};
+        }
+    }
+};
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <string_view>
+namespace DotMatrix {
+
+///Renders endless scrolling text into a small ring frame buffer
+/**
+ * The frame buffer is used as a ring buffer of rows in portrait orientation,
+ * text is rotated about 90 degrees (as in examples/textscroll). The driver
+ * wraps fb_offset at the end of the frame buffer. The renderer renders glyph
+ * columns just before they scroll into view, so the text can be arbitrarily long
+ * and it can be supplied while the text is scrolling.
+ *
+ * Scroll position is index of the first visible row. Rows are rendered up to
+ * position + height of the frame buffer. The height must be at least 12 (visible rows),
+ * every additional row allows update() to be called one row later.
+ *
+ * Every glyph column is rendered as one span of a row, so glyphs can be at most
+ * 8 pixels high. Higher fonts are rejected at compile time.
+ *
+ * @tparam FrameBuffer type of frame buffer, for example FrameBuffer<8,16>
+ * @tparam Font type of font
+ */
+template<typename FrameBuffer, typename Font>
+class MarqueeRenderer {
+public:
+
+    ///count of visible rows
+    static constexpr unsigned int visible_rows = 12;
+    ///bytes per row of the frame buffer
+    static constexpr unsigned int bytes_per_row = FrameBuffer::width * FrameBuffer::bits_per_pixel / 8;
+
+    static_assert(FrameBuffer::height >= visible_rows, "Frame buffer is too small");
+    static_assert(bytes_per_row * 8 == FrameBuffer::width * FrameBuffer::bits_per_pixel, "Unaligned frame buffer");
+    static_assert(FontHeight<Font>::value <= 8, "Glyphs higher than 8 pixels are not supported");
+
+    ///construct renderer
+    /**
+     * @param fb frame buffer
+     * @param font font
+     * @param x column where top of glyphs is rendered (as TextRender with Rotation::rot90)
+     * @param colors colors
+     */
+    constexpr MarqueeRenderer(FrameBuffer &fb, const Font &font,
+            int x = FrameBuffer::width - 1, ColorMap colors = {})
+        :_fb(fb), _font(font), _x(x), _colors(colors) {}
+
+    ///render rows which are about to scroll into view
+    /**
+     * @param position current scroll position (first visible row)
+     * @param next_char function which returns code point of the next character.
+     * It can return negative number, when no text is available. Then empty rows
+     * are rendered
+     */
+    template<typename Fn>
+    void update(unsigned int position, Fn &&next_char) {
+        if (static_cast<int>(position - _rendered) > 0) _rendered = position;
+        unsigned int limit = position + FrameBuffer::height;
+        while (static_cast<int>(limit - _rendered) > 0) {
+            render_row(_rendered % FrameBuffer::height, next_char);
+            ++_rendered;
+        }
+    }
+
+    ///calculate fb_offset of the driver for given position
+    static constexpr unsigned int fb_offset(unsigned int position) {
+        return (position % FrameBuffer::height) * bytes_per_row;
+    }
+
+protected:
+    FrameBuffer &_fb;
+    const Font &_font;
+    int _x;
+    ColorMap _colors;
+    unsigned int _rendered = 0;
+    int _code = -1;
+    unsigned int _column = 0;
+    unsigned int _advance = 0;
+
+    template<typename Fn>
+    void render_row(int row, Fn &next_char) {
+        using Kernel = BlitKernel<BltOp::copy>;
+        for (int c = 0; c < static_cast<int>(FrameBuffer::width); c += 8) {
+            Kernel::clipped_span(_fb, c, row, 0, 8, _colors);
+        }
+        if (_column >= _advance) {
+            _code = next_char();
+            _column = 0;
+            _advance = _code < 0?1:get_advance(_code);
+        }
+        if (_code < 0) return;
+        do_for_character(_font, _code, [&](auto spec){
+            const auto &face = spec.get_face();
+            constexpr int h = FontHeight<Font>::value;
+            if (static_cast<int>(_column) >= face.get_width()) return;
+            uint8_t bits = 0;
+            for (int y = 0; y < h; ++y) {
+                bits |= face.get_pixel(_column, y) << y;
+            }
+            Kernel::clipped_span(_fb, _x - h + 1, row,
+                    static_cast<uint8_t>(Kernel::reverse8(bits) >> (8 - h)), h, _colors);
+        });
+        ++_column;
+    }
+
+    unsigned int get_advance(int code) const {
+        return do_for_character(_font, code, [&](auto spec) -> unsigned int {
+            return spec.get_width();
+        });
+    }
+};
+
+///Source of text for MarqueeRenderer which repeats UTF-8 text forever
+struct MarqueeText {
+    ///text
+    std::string_view text;
+    ///position of the next character
+    std::size_t pos = 0;
+
+    ///retrieve next character
+    int operator()() {
+        if (text.empty()) return -1;
+        if (pos >= text.size()) pos = 0;
+        return decode_utf8(text, pos);
+    }
+};
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+namespace DotMatrix {
+
+///Fixed capacity scheduler of periodic and one-shot tasks
+/**
+ * Time is counted in ticks. Tasks are kept in a min-heap ordered by due time,
+ * so advance() costs one compare when nothing is due. Scheduling and canceling
+ * costs O(log N)
+ *
+ * The auto drive timer hosts one instance, see schedule_task()
+ *
+ * @tparam N capacity (max 255)
+ */
+template<unsigned int N>
+class TickScheduler {
+public:
+
+    static_assert(N > 0 && N < 255, "Invalid capacity");
+
+    ///returned when task can't be scheduled
+    static constexpr int invalid_task = -1;
+
+    ///schedule a task
+    /**
+     * @param fn function to call
+     * @param delay ticks to the first call (0 - at the next advance())
+     * @param period period in ticks, 0 - one-shot task
+     * @return id of task, or invalid_task if the scheduler is full
+     */
+    int schedule(TimerFunction fn, unsigned int delay, unsigned int period = 0) {
+        if (_count >= N) return invalid_task;
+        uint8_t id = 0;
+        while (_pos[id]) ++id;
+        Task &t = _tasks[id];
+        t.fn = fn;
+        t.due = _now + delay;
+        t.period = period;
+        _heap[_count] = id;
+        _pos[id] = static_cast<uint8_t>(_count + 1);
+        ++_count;
+        sift_up(_count - 1);
+        return id;
+    }
+
+    ///cancel a task
+    /**
+     * @param id id of task
+     * @retval true canceled
+     * @retval false not found (one-shot task already executed)
+     */
+    bool cancel(int id) {
+        if (id < 0 || id >= static_cast<int>(N) || !_pos[id]) return false;
+        remove_at(_pos[id] - 1);
+        return true;
+    }
+
+    ///advance time and call due tasks
+    /**
+     * @param ticks elapsed ticks
+     */
+    void advance(unsigned int ticks) {
+        _now += ticks;
+        while (_count && static_cast<int>(_tasks[_heap[0]].due - _now) <= 0) {
+            uint8_t id = _heap[0];
+            Task &t = _tasks[id];
+            TimerFunction fn = t.fn;
+            if (t.period) {
+                t.due += t.period;
+                sift_down(0);
+            } else {
+                remove_at(0);
+            }
+            fn();
+        }
+    }
+
+    ///current time in ticks
+    unsigned int now() const {return _now;}
+
+    ///count of scheduled tasks
+    unsigned int size() const {return _count;}
+
+protected:
+    struct Task {
+        TimerFunction fn;
+        unsigned int due = 0;
+        unsigned int period = 0;
+    };
+
+    Task _tasks[N] = {};
+    ///heap of task ids
+    uint8_t _heap[N] = {};
+    ///position of task in the heap + 1 (0 - not scheduled)
+    uint8_t _pos[N] = {};
+    unsigned int _count = 0;
+    unsigned int _now = 0;
+
+    bool before(unsigned int a, unsigned int b) const {
+        return static_cast<int>(_tasks[_heap[a]].due - _tasks[_heap[b]].due) < 0;
+    }
+    void swap(unsigned int a, unsigned int b) {
+        std::swap(_heap[a], _heap[b]);
+        _pos[_heap[a]] = static_cast<uint8_t>(a + 1);
+        _pos[_heap[b]] = static_cast<uint8_t>(b + 1);
+    }
+    void sift_up(unsigned int i) {
+        while (i > 0) {
+            unsigned int p = (i - 1) / 2;
+            if (!before(i, p)) break;
+            swap(i, p);
+            i = p;
+        }
+    }
+    void sift_down(unsigned int i) {
+        while (true) {
+            unsigned int l = 2 * i + 1;
+            unsigned int r = l + 1;
+            unsigned int m = i;
+            if (l < _count && before(l, m)) m = l;
+            if (r < _count && before(r, m)) m = r;
+            if (m == i) break;
+            swap(i, m);
+            i = m;
+        }
+    }
+    void remove_at(unsigned int i) {
+        _pos[_heap[i]] = 0;
+        --_count;
+        if (i == _count) return;
+        _heap[i] = _heap[_count];
+        _pos[_heap[i]] = static_cast<uint8_t>(i + 1);
+        sift_down(i);
+        sift_up(i);
+    }
+};
+
+}
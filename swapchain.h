@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+namespace DotMatrix {
+
+///Set of frame buffers with tear-free page flipping
+/**
+ * The main loop renders into the back() buffer and calls present() when the
+ * frame is complete. The driver displays the front() buffer. The presented buffer
+ * becomes front when the current scan is finished (after the row 10), so displayed
+ * image is never mixed from two frames. No copying is involved and interrupts
+ * are never disabled.
+ *
+ * @tparam FrameBuffer type of frame buffer
+ * @tparam N count of buffers. With 2 buffers (double buffering) present() waits
+ * until the flip happens (at most one scan). With 3 and more buffers (triple buffering)
+ * present() never waits. If the previous frame was not displayed yet, it is dropped
+ */
+template<typename FrameBuffer, unsigned int N = 2>
+class SwapChain {
+public:
+
+    static_assert(N >= 2, "At least two buffers are required");
+    static_assert(N < 255, "Too many buffers");
+
+    ///retrieve buffer for rendering (main loop)
+    /**
+     * @return reference to back buffer. Its content is undefined, it
+     * contains some older frame
+     */
+    FrameBuffer &back() {
+        return _buffers[_back];
+    }
+
+    ///retrieve buffer to display (interrupt)
+    const FrameBuffer &front() const {
+        return _buffers[_front.load()];
+    }
+
+    ///present back buffer (main loop)
+    /**
+     * Marks back buffer to be displayed from the next scan and picks a
+     * new back buffer
+     */
+    void present() {
+        uint8_t dropped = _pending.exchange(_back);
+        if (dropped != none) {
+            //previous frame was not displayed, reuse its buffer
+            _back = dropped;
+            return;
+        }
+        while (true) {
+            //pending must be read before front - flip can happen between
+            uint8_t p = _pending.load();
+            uint8_t f = _front.load();
+            for (uint8_t i = 0; i < N; ++i) {
+                if (i != p && i != f) {
+                    _back = i;
+                    return;
+                }
+            }
+        }
+    }
+
+    ///flip buffers (interrupt)
+    /**
+     * Must be called after the driver finished the scan, see Driver::scan_complete()
+     *
+     * @retval true flipped, new frame is displayed
+     * @retval false no frame is pending
+     */
+    bool flip() {
+        uint8_t p = _pending.exchange(none);
+        if (p == none) return false;
+        _front.store(p);
+        return true;
+    }
+
+protected:
+    static constexpr uint8_t none = 0xFF;
+
+    FrameBuffer _buffers[N] = {};
+    std::atomic<uint8_t> _front = {0};
+    std::atomic<uint8_t> _pending = {none};
+    uint8_t _back = 1;
+};
+
+///Enables automatic driving of a swap chain (using timer and interrupt)
+/**
+ * @param driver reference to driver
+ * @param st reference to state variable
+ * @param chain reference to swap chain. The presented frame is flipped at the end of the scan
+ */
+template<typename FrameBuffer, Orientation _orientation, int _offset, unsigned int N>
+void enable_auto_drive(const Driver<FrameBuffer, _orientation, _offset> &driver,
+         State &st, SwapChain<FrameBuffer, N> &chain) {
+
+    enable_auto_drive([&driver, &st, &chain]{
+        driver.drive(st, chain.front());
+        driver.adjust_auto_drive(st);
+        if (driver.scan_complete(st)) chain.flip();
+    }, FrameBuffer::recommended_refresh_freq);
+}
+
+}
@@ -0,0 +1,32 @@
+#include "DotMatrixSim.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+//Host proxy of examples/benchmark: mean time of Driver::drive() per tick
+//with simulated ports. Not a test, run it manually (build target bench_drive)
+
+using namespace DotMatrix;
+
+constexpr unsigned int iterations = 20000000;
+
+template<typename FB, Orientation o>
+static void bench(const char *name, unsigned int fb_step, unsigned int px_offset = 0) {
+    static FB fb;
+    for (auto &p: fb.pixels) p = static_cast<uint8_t>(std::rand());
+    constexpr Driver<FB, o> driver = {};
+    State st;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < iterations; ++i) driver.drive(st, fb, (i / 11) * fb_step, px_offset);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    std::printf("%-24s %6.2f ns/tick\n", name, ns);
+}
+
+int main() {
+    bench<FrameBuffer<12, 8>, Orientation::landscape>("mono", 0);
+    bench<FrameBuffer<12, 8, Format::gray_blink_2bit>, Orientation::landscape>("gray", 0);
+    bench<FrameBuffer<12, 8, Format::gray_bcm_4bit>, Orientation::landscape>("bcm4", 0);
+    bench<FrameBuffer<8, 576>, Orientation::portrait>("mono 8x576 scroll", 1);
+    bench<FrameBuffer<8, 576>, Orientation::portrait>("mono 8x576 px_offset", 1, 3);
+    return 0;
+}
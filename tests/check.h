@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdio>
+
+///count of failed checks, returned from main() by CHECK_RESULT()
+inline int check_failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { \
+    ++check_failures; std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+#define CHECK_EQ(a, b) do { auto check_a_ = (a); auto check_b_ = (b); if (!(check_a_ == check_b_)) { \
+    ++check_failures; std::printf("%s:%d: check failed: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #a, #b, \
+            static_cast<long long>(check_a_), static_cast<long long>(check_b_)); } } while (0)
+
+#define CHECK_RESULT() (check_failures?(std::printf("%d check(s) failed\n", check_failures), 1):0)
@@ -0,0 +1,13 @@
+//BitBlt, 2 bitmaps x 1 frame buffer
+#include "DotMatrix.h"
+using namespace DotMatrix;
+
+constexpr Bitmap<8, 8> a = {};
+constexpr Bitmap<16, 5> b = {};
+FrameBuffer<12, 8> f1;
+
+void bitblt(int x, int y) {
+    BitBlt<>::bitblt(a, f1, x, y);
+    BitBlt<BltOp::or_op>::bitblt(b, f1, x, y);
+    BitBlt<BltOp::copy, Rotation::rot90>::bitblt(a, f1, x, y);
+}
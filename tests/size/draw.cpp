@@ -0,0 +1,16 @@
+//Bitmap::draw() with runtime operation and rotation, 3 bitmaps x 3 frame buffers
+#include "DotMatrix.h"
+using namespace DotMatrix;
+
+constexpr Bitmap<8, 8> a("xxxxxxxx" "x      x" "x      x" "x      x" "x      x" "x      x" "x      x" "xxxxxxxx");
+constexpr Bitmap<12, 5> b = {};
+constexpr Bitmap<16, 16> c = {};
+FrameBuffer<12, 8> f1;
+FrameBuffer<12, 8, Format::gray_blink_2bit> f2;
+TrackedFrameBuffer<16, 16> f3;
+
+void draw_all(int x, int y, BltOp op, Rotation r) {
+    a.draw(f1, x, y, {}, op, r); b.draw(f1, x, y, {}, op, r); c.draw(f1, x, y, {}, op, r);
+    a.draw(f2, x, y, {}, op, r); b.draw(f2, x, y, {}, op, r); c.draw(f2, x, y, {}, op, r);
+    a.draw(f3, x, y, {}, op, r); b.draw(f3, x, y, {}, op, r); c.draw(f3, x, y, {}, op, r);
+}
@@ -0,0 +1,19 @@
+//BitBlt, 6 bitmaps x 3 frame buffers
+#include "DotMatrix.h"
+using namespace DotMatrix;
+
+constexpr Bitmap<8, 8> a = {}; constexpr Bitmap<16, 5> b = {}; constexpr Bitmap<5, 7> c = {};
+constexpr Bitmap<12, 8> d = {}; constexpr Bitmap<3, 3> e = {}; constexpr Bitmap<24, 8> g = {};
+FrameBuffer<12, 8> f1;
+FrameBuffer<8, 96> f2;
+FrameBuffer<12, 8, Format::gray_blink_2bit> f3;
+
+template<typename FB>
+void one(FB &fb, int x, int y) {
+    BitBlt<>::bitblt(a, fb, x, y); BitBlt<>::bitblt(b, fb, x, y); BitBlt<>::bitblt(c, fb, x, y);
+    BitBlt<>::bitblt(d, fb, x, y); BitBlt<>::bitblt(e, fb, x, y); BitBlt<>::bitblt(g, fb, x, y);
+    BitBlt<BltOp::or_op, Rotation::rot90>::bitblt(a, fb, x, y);
+    BitBlt<BltOp::or_op, Rotation::rot90>::bitblt(g, fb, x, y);
+}
+
+void many(int x, int y) { one(f1, x, y); one(f2, x, y); one(f3, x, y); }
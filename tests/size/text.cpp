@@ -0,0 +1,12 @@
+//render_text, 3 renderers
+#include "DotMatrix.h"
+using namespace DotMatrix;
+
+FrameBuffer<12, 8> f1;
+FrameBuffer<8, 96> f2;
+
+void text(int x, const char *s) {
+    TextRender<>::render_text(f1, font_6p, x, 0, s);
+    TextRender<BltOp::copy, Rotation::rot90>::render_text(f2, font_6p, 7, x, s);
+    TextRender<BltOp::xor_op>::render_text(f1, font_5x3, x, 0, s);
+}
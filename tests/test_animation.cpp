@@ -0,0 +1,143 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+#include <cstring>
+
+using namespace DotMatrix;
+
+//frames encoded at compile time are decoded back by AnimationPlayer
+
+using FB = FrameBuffer<12, 8>;
+
+//12 bytes per frame, not a multiple of the group of 7 bytes
+constexpr uint32_t words[][4] = {
+    {0x00000000, 0x00000000, 0x00000000, 100},
+    {0xF0000000, 0x00000000, 0x0000000F, 100},
+    {0xF0000000, 0x00000000, 0x0000000F, 250},
+    {0x12345678, 0x9ABCDEF0, 0x0FEDCBA9, 250},
+    {0x12345678, 0x00000000, 0x0FEDCBA9, 70000},
+};
+constexpr auto small_frames = frames_from_words<FB>(words);
+constexpr auto small_anim = encode_animation<small_frames>();
+static_assert(small_frames[4].duration == animation_hold);
+
+//300 bytes per frame, frames with skips over 128 bytes, full changes and no change
+using BigFB = FrameBuffer<20, 30, Format::gray_bcm_4bit, Order::lsb_to_msb>;
+constexpr auto make_big_frames() {
+    std::array<AnimationFrame<BigFB>, 7> out = {};
+    //first and last byte
+    out[0].fb.pixels[0] = 0x12;
+    out[0].fb.pixels[BigFB::count_bytes - 1] = 0x34;
+    out[0].duration = 40;
+    //same content, other duration
+    out[1].fb = out[0].fb;
+    out[1].duration = 41;
+    //every byte changed
+    for (unsigned int i = 0; i < BigFB::count_bytes; ++i) {
+        out[2].fb.pixels[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+    out[2].duration = 41;
+    //sparse changes, gaps of 1-6 and 129-140 bytes
+    out[3].fb = out[2].fb;
+    for (unsigned int i = 0, gap = 1; i < BigFB::count_bytes; i += gap, gap = gap < 6?gap + 1:gap == 6?129:gap + 1) {
+        out[3].fb.pixels[i] ^= 0xFF;
+    }
+    out[3].duration = 0;
+    //filled box
+    out[4].fb = out[3].fb;
+    out[4].fb.draw_box(3, 10, 15, 20, 9);
+    out[4].duration = 1000;
+    //only the last byte changed
+    out[5].fb = out[4].fb;
+    out[5].fb.pixels[BigFB::count_bytes - 1] ^= 0x80;
+    out[5].duration = 1000;
+    //cleared
+    out[6].duration = 2;
+    return out;
+}
+constexpr auto big_frames = make_big_frames();
+constexpr auto big_anim = encode_animation<big_frames>();
+static_assert(BigFB::count_bytes % 7 != 0);
+
+template<typename Anim, typename Frames>
+static void test_decode(const Anim &anim, const Frames &frames) {
+    using FrameBuffer = typename Anim::FrameBuffer;
+    CHECK_EQ(Anim::size, encoded_animation_size(frames));
+    AnimationPlayer<Anim> player(anim);
+    FrameBuffer fb;
+    std::memset(fb.pixels, 0xAA, sizeof(fb.pixels));
+    //the second round follows the wrap to the first frame
+    for (unsigned int round = 0; round < 2; ++round) {
+        for (const auto &f: frames) {
+            uint16_t duration = player.decode_next(fb);
+            CHECK_EQ(duration, f.duration);
+            CHECK(std::memcmp(fb.pixels, f.fb.pixels, sizeof(fb.pixels)) == 0);
+        }
+    }
+}
+
+static void test_ascii() {
+    using AsciiFB = FrameBuffer<5, 3, Format::gray_blink_2bit>;
+    static constexpr AnimationFrame<AsciiFB> frames[] = {
+        frame_from_ascii<AsciiFB>("x   x"
+                                  " 1 2 "
+                                  "x   x", 30),
+        frame_from_ascii<AsciiFB>("     "
+                                  "  3  "
+                                  "     ", 30),
+        frame_from_ascii<AsciiFB>("     "
+                                  "  3  "
+                                  "     ", animation_hold),
+    };
+    static constexpr auto anim = encode_animation<frames>();
+    test_decode(anim, frames);
+}
+
+//ticks of auto drive during the frame
+template<typename FrameBuffer>
+static unsigned int frame_ticks(uint16_t duration) {
+    constexpr unsigned int ticks_per_row = FrameBuffer::bcm_bits?FrameBuffer::bcm_bits:FrameBuffer::bits_per_pixel;
+    constexpr unsigned int rows_per_second = FrameBuffer::recommended_refresh_freq
+            / (FrameBuffer::bcm_bits?(1U << FrameBuffer::bcm_bits) - 1:FrameBuffer::bits_per_pixel);
+    return static_cast<uint32_t>(duration) * rows_per_second / 1000 * ticks_per_row;
+}
+
+//frames presented through SwapChain when the previous one expires. The back
+//buffer holds an older (or dropped) frame, the last decoded frame is copied into it first
+template<unsigned int N, typename Anim, typename Frames>
+static void test_swap_chain(const Anim &anim, const Frames &frames, unsigned int flip_mask) {
+    using FrameBuffer = typename Anim::FrameBuffer;
+    SwapChain<FrameBuffer, N> chain;
+    AnimationPlayer<Anim> player(anim, false);
+    State st;
+    unsigned int due = 0;
+    for (unsigned int i = 0; i < std::size(frames); ++i) {
+        CHECK(!player.finished());
+        if (due) {
+            st.counter += due - 1;
+            CHECK(!player.update(st, chain));
+            st.counter += 1;
+        }
+        CHECK(player.update(st, chain));
+        if ((flip_mask >> i) & 1) {
+            CHECK(chain.flip());
+            CHECK(std::memcmp(chain.front().pixels, frames[i].fb.pixels, sizeof(FrameBuffer::pixels)) == 0);
+        }
+        due = frame_ticks<FrameBuffer>(frames[i].duration);
+    }
+    st.counter += due;
+    CHECK(!player.update(st, chain));
+    CHECK(player.finished());
+}
+
+int main() {
+    test_decode(small_anim, small_frames);
+    test_decode(big_anim, big_frames);
+    test_ascii();
+    //every frame is flipped
+    test_swap_chain<3>(small_anim, small_frames, 0x1F);
+    test_swap_chain<3>(big_anim, big_frames, 0x7F);
+    //some frames are dropped before the flip
+    test_swap_chain<3>(big_anim, big_frames, 0x45);
+    test_swap_chain<4>(big_anim, big_frames, 0x52);
+    return CHECK_RESULT();
+}
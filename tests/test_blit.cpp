@@ -0,0 +1,118 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+#include <cstdlib>
+#include <cstring>
+
+using namespace DotMatrix;
+
+//Blit kernels are compared with the per-pixel path (blit_pixels())
+//for all operations, rotations and clip positions
+
+template<unsigned int w, unsigned int h>
+static Bitmap<w, h> random_bitmap() {
+    Bitmap<w, h> bm = {};
+    for (unsigned int y = 0; y < h; ++y) {
+        for (unsigned int x = 0; x < w; ++x) if (std::rand() & 1) bm.set_pixel(x, y);
+    }
+    return bm;
+}
+
+template<typename FB, typename BM>
+static void test_equivalence(const BM &bm) {
+    for (unsigned int op = 0; op < 7; ++op) {
+        for (unsigned int r = 0; r < 4; ++r) {
+            for (int x = -45; x < 22; x += 3) {
+                for (int y = -18; y < 22; y += 3) {
+                    FB a;
+                    FB b;
+                    for (unsigned int i = 0; i < FB::count_bytes; ++i) {
+                        a.pixels[i] = b.pixels[i] = static_cast<uint8_t>(std::rand());
+                    }
+                    ColorMap cols{static_cast<uint8_t>(std::rand() & 3), static_cast<uint8_t>(std::rand() & 3)};
+                    draw_bitmap(bm, a, x, y, cols, BltOp(op), Rotation(r));
+                    blit_pixels(bm, b, x, y, cols, BltOp(op), Rotation(r));
+                    CHECK(std::memcmp(a.pixels, b.pixels, FB::count_bytes) == 0);
+                }
+            }
+        }
+    }
+}
+
+template<typename FB>
+static void test_sources() {
+    static const auto b1 = random_bitmap<5, 3>();
+    static const auto b2 = random_bitmap<8, 8>();
+    static const auto b3 = random_bitmap<13, 11>();
+    static constexpr auto packed = pack_font<font_6p>();
+    test_equivalence<FB>(b1);
+    test_equivalence<FB>(b2);
+    test_equivalence<FB>(b3);
+    test_equivalence<FB>(BitmapView(b3));
+    test_equivalence<FB>(packed['g' - 32]);
+}
+
+//spans far left of the frame buffer are clipped in constant expressions too
+constexpr bool draw_far_left() {
+    Bitmap<8, 8> bm = {};
+    for (unsigned int i = 0; i < 8; ++i) bm.set_pixel(i, i);
+    FrameBuffer<12, 8> fb = {};
+    for (int r = 0; r < 4; ++r) {
+        draw_bitmap(bm, fb, -40, 0, {}, BltOp::copy, Rotation(r));
+        draw_bitmap(bm, fb, -300, 0, {}, BltOp::copy, Rotation(r));
+    }
+    for (auto p: fb.pixels) if (p) return false;
+    return true;
+}
+static_assert(draw_far_left());
+
+//BitmapView reads pixels of the bitmap, outside is empty
+static void test_view() {
+    Bitmap<3, 2> bm = {};
+    bm.set_pixel(0, 0);
+    bm.set_pixel(2, 1);
+    BitmapView v(bm);
+    CHECK(v.get_pixel(0, 0));
+    CHECK(!v.get_pixel(1, 0));
+    CHECK(v.get_pixel(2, 1));
+    CHECK(!v.get_pixel(5, 5));
+}
+
+//changed pixels are inside the dirty region
+static void test_dirty() {
+    static const auto bm = random_bitmap<5, 3>();
+    for (unsigned int r = 0; r < 4; ++r) {
+        for (int x = -6; x < 18; x += 2) {
+            for (int y = -6; y < 18; y += 2) {
+                TrackedFrameBuffer<16, 16> fb;
+                fb.clear(1);
+                fb.clear_dirty();
+                draw_bitmap(bm, fb, x, y, {}, BltOp::copy, Rotation(r));
+                DirtyRegion d = fb.dirty();
+                for (unsigned int py = 0; py < 16; ++py) {
+                    for (unsigned int px = 0; px < 16; ++px) {
+                        if (fb.get_pixel(px, py) != 1) {
+                            CHECK(!d.empty() && px >= d.x0 && px <= d.x1 && py >= d.y0 && py <= d.y1);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    TrackedFrameBuffer<16, 16> fb;
+    fb.clear_dirty();
+    BitBlt<BltOp::copy, Rotation::rot90>::bitblt(Bitmap<5, 3>{}, fb, 10, 2);
+    DirtyRegion d = fb.dirty();
+    CHECK_EQ(d.x0, 8U);
+    CHECK_EQ(d.y0, 2U);
+    CHECK_EQ(d.x1, 10U);
+    CHECK_EQ(d.y1, 6U);
+}
+
+int main() {
+    test_sources<FrameBuffer<16, 12> >();
+    test_sources<FrameBuffer<16, 12, Format::gray_blink_2bit> >();
+    test_sources<FrameBuffer<11, 9> >();
+    test_view();
+    test_dirty();
+    return CHECK_RESULT();
+}
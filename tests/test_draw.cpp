@@ -0,0 +1,134 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+#include <cstdlib>
+#include <cstring>
+
+using namespace DotMatrix;
+
+//draw_box() and axis-aligned draw_line() fill byte spans, they are compared
+//with pixels set one by one by set_pixel()
+
+template<typename FB>
+static void randomize(FB &a, FB &b) {
+    for (unsigned int i = 0; i < FB::count_bytes; ++i) {
+        a.pixels[i] = b.pixels[i] = static_cast<uint8_t>(std::rand());
+    }
+}
+
+//bit 3 of gray_bcm_3bit pixels is not displayed, set_pixel() keeps it and spans clear it
+template<typename FB>
+static bool same(const FB &a, const FB &b) {
+    if constexpr(FB::mask == (1 << FB::bits_per_pixel) - 1) {
+        return std::memcmp(a.pixels, b.pixels, FB::count_bytes) == 0;
+    } else {
+        for (unsigned int y = 0; y < FB::height; ++y) {
+            for (unsigned int x = 0; x < FB::width; ++x) {
+                if (a.get_pixel(x, y) != b.get_pixel(x, y)) return false;
+            }
+        }
+        return true;
+    }
+}
+
+template<typename FB>
+static void reference_box(FB &fb, int x0, int y0, int x1, int y1, uint8_t color) {
+    if (x0 > x1) std::swap(x0, x1);
+    if (y0 > y1) std::swap(y0, y1);
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            //negative coordinates wrap to large values and are ignored
+            fb.set_pixel(static_cast<unsigned int>(x), static_cast<unsigned int>(y), color);
+        }
+    }
+}
+
+//coordinates run from left/top of the buffer to past its right/bottom edge, in both directions
+template<typename FB>
+static void test_box() {
+    constexpr int w = FB::width;
+    constexpr int h = FB::height;
+    for (int y0 = -3; y0 < h + 3; ++y0) {
+        for (int y1 = -3; y1 < h + 3; y1 += 2) {
+            for (int x0 = -3; x0 < w + 3; ++x0) {
+                for (int x1 = -3; x1 < w + 3; ++x1) {
+                    FB a;
+                    FB b;
+                    randomize(a, b);
+                    uint8_t color = static_cast<uint8_t>(std::rand());
+                    a.draw_box(x0, y0, x1, y1, color);
+                    reference_box(b, x0, y0, x1, y1, color);
+                    CHECK(same(a, b));
+                }
+            }
+        }
+    }
+}
+
+//Bresenham's line by set_pixel(), clipped per pixel
+template<typename FB>
+static void reference_line(FB &fb, int x0, int y0, int x1, int y1, uint8_t color) {
+    int dx = std::abs(x1 - x0);
+    int dy = std::abs(y1 - y0);
+    int sx = x0 < x1?1:-1;
+    int sy = y0 < y1?1:-1;
+    int err = dx - dy;
+    while (true) {
+        fb.set_pixel(static_cast<unsigned int>(x0), static_cast<unsigned int>(y0), color);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x0 += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+//horizontal and vertical lines take the span path, others are drawn pixel by pixel
+template<typename FB>
+static void test_line() {
+    constexpr int w = FB::width;
+    constexpr int h = FB::height;
+    for (int y0 = -3; y0 < h + 3; ++y0) {
+        for (int y1 = -3; y1 < h + 3; ++y1) {
+            for (int x0 = -3; x0 < w + 3; ++x0) {
+                for (int x1 = -3; x1 < w + 3; ++x1) {
+                    FB a;
+                    FB b;
+                    randomize(a, b);
+                    uint8_t color = static_cast<uint8_t>(std::rand());
+                    a.draw_line(x0, y0, x1, y1, color);
+                    reference_line(b, x0, y0, x1, y1, color);
+                    CHECK(same(a, b));
+                }
+            }
+        }
+    }
+}
+
+template<typename FB>
+static void test_all() {
+    test_box<FB>();
+    test_line<FB>();
+}
+
+template<Format f, Order o>
+static void test_format() {
+    test_all<FrameBuffer<12, 8, f, o> >();
+    test_all<FrameBuffer<13, 5, f, o> >();
+    test_all<FrameBuffer<7, 6, f, o> >();
+    test_all<FrameBuffer<16, 3, f, o> >();
+}
+
+int main() {
+    test_format<Format::monochrome_1bit, Order::msb_to_lsb>();
+    test_format<Format::monochrome_1bit, Order::lsb_to_msb>();
+    test_format<Format::gray_blink_2bit, Order::msb_to_lsb>();
+    test_format<Format::gray_blink_2bit, Order::lsb_to_msb>();
+    test_format<Format::gray_bcm_3bit, Order::msb_to_lsb>();
+    test_format<Format::gray_bcm_4bit, Order::lsb_to_msb>();
+    return CHECK_RESULT();
+}
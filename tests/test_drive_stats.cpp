@@ -0,0 +1,46 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+
+using namespace DotMatrix;
+
+//interrupts of the simulator are never late, so no tick is missed, also
+//when BCM changes the period from tick to tick
+template<typename FB>
+static void test_no_missed_ticks(unsigned int ticks) {
+    static constexpr Driver<FB, Orientation::landscape> driver = {};
+    static FB fb = {};
+    static State st;
+    static DriveStatsRecorder recorder;
+    fb.clear(1);
+    enable_auto_drive(driver, st, fb);
+    set_auto_drive_stats(&recorder);
+    DriveStats s;
+    CHECK(!recorder.snapshot(s));
+    //the requested block is published by the next tick and the next block starts
+    Simulator::run_auto_drive(1);
+    Simulator::run_auto_drive(ticks - 1);
+    CHECK(recorder.snapshot(s));
+    CHECK_EQ(s.ticks, 1UL);
+    Simulator::run_auto_drive(1);
+    CHECK(recorder.snapshot(s));
+    CHECK_EQ(s.ticks, static_cast<unsigned long>(ticks));
+    CHECK_EQ(s.missed_ticks, 0UL);
+    CHECK_EQ(s.counter_freq, cycle_counter_freq());
+    //intervals sum to whole scans, up to the alignment of the block to the scan
+    unsigned int scan_periods = FB::bcm_bits?(1U << FB::bcm_bits) - 1:1;
+    unsigned int scan_ticks = FB::bcm_bits?FB::bcm_bits:1;
+    long long expected = 1000000000LL * scan_periods / FB::recommended_refresh_freq * ticks / scan_ticks;
+    long long longest = 1000000000LL * (FB::bcm_bits?1U << (FB::bcm_bits - 1):1) / FB::recommended_refresh_freq;
+    long long diff = static_cast<long long>(s.elapsed_cycles) - expected;
+    CHECK(diff < longest && diff > -longest);
+    set_auto_drive_stats(nullptr);
+    disable_auto_drive();
+}
+
+int main() {
+    test_no_missed_ticks<FrameBuffer<12, 8> >(1100);
+    test_no_missed_ticks<FrameBuffer<12, 8, Format::gray_blink_2bit> >(2200);
+    test_no_missed_ticks<FrameBuffer<12, 8, Format::gray_bcm_3bit> >(3300);
+    test_no_missed_ticks<FrameBuffer<12, 8, Format::gray_bcm_4bit> >(4400);
+    return CHECK_RESULT();
+}
@@ -0,0 +1,110 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+#include <cstdlib>
+
+using namespace DotMatrix;
+
+//Driver::drive() is compared with two baselines:
+// - pixels read from the buffer, mapped by orientation, order and offsets
+// - generic scanning loop (LayerStack with single overwrite layer)
+
+template<typename FB>
+static void randomize(FB &fb) {
+    for (auto &p: fb.pixels) p = static_cast<uint8_t>(std::rand());
+}
+
+//pixel displayed on LED x,y (landscape) with byte offset and pixel offset
+template<typename FB, Orientation o>
+static unsigned int expected_pixel(const FB &fb, unsigned int x, unsigned int y,
+        unsigned int fb_offset, unsigned int px_offset) {
+    unsigned int i;
+    switch (o) {
+        default:
+        case Orientation::landscape: i = y * FB::width + x; break;
+        case Orientation::portrait: i = (7 - y) + x * FB::width; break;
+        case Orientation::reverse_landscape: i = (7 - y) * FB::width + (11 - x); break;
+        case Orientation::reverse_portrait: i = y + (11 - x) * FB::width; break;
+    }
+    unsigned int bit = (i + px_offset) * FB::bits_per_pixel + fb_offset * 8;
+    unsigned int shift = bit % 8;
+    if (FB::order == Order::lsb_to_msb) shift = 8 - FB::bits_per_pixel - shift;
+    return (fb.pixels[(bit / 8) % FB::count_bytes] >> shift) & FB::mask;
+}
+
+//LEDs lit during one scan match non-zero pixels
+template<typename FB, Orientation o>
+static void test_reference() {
+    static FB fb;
+    randomize(fb);
+    constexpr Driver<FB, o> driver = {};
+    for (unsigned int px = 0; px < 9; ++px) {
+        for (unsigned int off = 0; off < 3; ++off) {
+            State st;
+            Simulator::reset();
+            std::bitset<DirectDrive::num_leds> lit;
+            for (unsigned int i = 0; i < Driver<FB, o>::ticks_per_row * 11; ++i) {
+                driver.drive(st, fb, off, px);
+                Simulator::tick();
+                lit |= Simulator::last_tick();
+            }
+            for (unsigned int y = 0; y < 8; ++y) {
+                for (unsigned int x = 0; x < 12; ++x) {
+                    bool on = expected_pixel<FB, o>(fb, x, y, off, px) != 0;
+                    CHECK_EQ(lit[y * 12 + x], on);
+                }
+            }
+        }
+    }
+}
+
+//unrolled row handlers produce the same line states as the generic loop
+template<typename FB, Orientation o>
+static void test_generic() {
+    static FB fb;
+    if constexpr(FB::byte_swizzle) {
+        uint32_t words[3];
+        for (auto &w: words) w = static_cast<uint32_t>(std::rand());
+        fb = FB(words);
+    } else {
+        randomize(fb);
+    }
+    constexpr Driver<FB, o> driver = {};
+    LayerStack<FB, 1> layers;
+    for (unsigned int off = 0; off < 2 * FB::count_bytes + 3; ++off) {
+        layers.set(0, fb, LayerOp::overwrite, off, 0);
+        State s1;
+        State s2;
+        for (unsigned int i = 0; i < 2 * Driver<FB, o>::ticks_per_row * 11; ++i) {
+            driver.drive(s1, fb, off);
+            Simulator::Line lines[11];
+            for (unsigned int l = 0; l < 11; ++l) lines[l] = Simulator::line_state(l);
+            driver.drive(s2, layers);
+            for (unsigned int l = 0; l < 11; ++l) CHECK(lines[l] == Simulator::line_state(l));
+        }
+    }
+}
+
+template<typename FB>
+static void test_all() {
+    test_reference<FB, Orientation::landscape>();
+    test_reference<FB, Orientation::portrait>();
+    test_reference<FB, Orientation::reverse_landscape>();
+    test_reference<FB, Orientation::reverse_portrait>();
+    test_generic<FB, Orientation::landscape>();
+    test_generic<FB, Orientation::portrait>();
+    test_generic<FB, Orientation::reverse_landscape>();
+    test_generic<FB, Orientation::reverse_portrait>();
+}
+
+int main() {
+    test_all<FrameBuffer<12, 12> >();
+    test_all<FrameBuffer<16, 24, Format::monochrome_1bit, Order::lsb_to_msb> >();
+    test_all<FrameBuffer<12, 12, Format::gray_blink_2bit> >();
+    test_all<FrameBuffer<12, 12, Format::gray_blink_2bit, Order::lsb_to_msb> >();
+    test_all<FrameBuffer<12, 12, Format::gray_bcm_3bit> >();
+    test_all<FrameBuffer<12, 12, Format::gray_bcm_4bit, Order::lsb_to_msb> >();
+    test_reference<FrameBuffer<8, 576>, Orientation::portrait>();
+    test_generic<FrameBuffer<8, 576>, Orientation::portrait>();
+    test_generic<LedMatrixFrame, Orientation::landscape>();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,60 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+
+using namespace DotMatrix;
+
+using FB = FrameBuffer<12, 8>;
+
+template<typename Queue>
+static void push_frames(Queue &q, uint8_t first, unsigned int count, unsigned int duration) {
+    for (unsigned int i = 0; i < count; ++i) {
+        FB *fb = q.acquire();
+        CHECK(fb != nullptr);
+        if (!fb) return;
+        fb->clear(0);
+        fb->pixels[0] = static_cast<uint8_t>(first + i);
+        CHECK(q.push(duration));
+    }
+}
+
+//producer is refused when full, frames are displayed in order for their duration
+static void test_hold_last() {
+    static FrameQueue<FB, 4, QueuePolicy::hold_last> q;
+    push_frames(q, 1, 3, 10);
+    CHECK_EQ(q.pending(), 3U);
+    CHECK(q.full());
+    CHECK(q.acquire() == nullptr);
+    CHECK(!q.push(10));
+    //first frame arrived late, it is displayed immediately
+    CHECK(q.advance(0));
+    CHECK_EQ(q.front().pixels[0], 1);
+    CHECK(!q.advance(9));
+    CHECK(q.advance(10));
+    CHECK_EQ(q.front().pixels[0], 2);
+    CHECK(q.advance(20));
+    CHECK_EQ(q.front().pixels[0], 3);
+    //underrun, the last frame is held
+    CHECK(!q.advance(30));
+    CHECK_EQ(q.front().pixels[0], 3);
+    CHECK_EQ(q.pending(), 0U);
+}
+
+//consumer skips to the newest frame, the producer is refused when full too
+static void test_skip_to_newest() {
+    static FrameQueue<FB, 4, QueuePolicy::skip_to_newest> q;
+    push_frames(q, 1, 3, 10);
+    CHECK(q.acquire() == nullptr);
+    CHECK(q.advance(0));
+    CHECK_EQ(q.front().pixels[0], 3);
+    CHECK_EQ(q.pending(), 0U);
+    push_frames(q, 4, 2, 10);
+    CHECK(!q.advance(5));
+    CHECK(q.advance(10));
+    CHECK_EQ(q.front().pixels[0], 5);
+}
+
+int main() {
+    test_hold_last();
+    test_skip_to_newest();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,44 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+#include <string_view>
+
+using namespace DotMatrix;
+
+static_assert(FontHeight<std::decay_t<decltype(font_6p)> >::value == 7);
+static_assert(FontHeight<std::decay_t<decltype(font_5x3)> >::value == 6);
+static_assert(FontHeight<std::decay_t<decltype(pack_font<font_6p>())> >::value == 7);
+
+//rows of the ring buffer equal rows of the whole text rendered by TextRender<copy, rot90>,
+//for every scroll position, also when update() is called later than each row
+template<typename FB, typename Font>
+static void test_marquee(const Font &font, int x, ColorMap colors, unsigned int step) {
+    static constexpr std::string_view text = "Hello, Marquee! 12345";
+    static constexpr unsigned int length = 160;
+    using FullFB = FrameBuffer<FB::width, length, FB::format>;
+    static FullFB full;
+    full.clear(colors.background);
+    TextRender<BltOp::copy, Rotation::rot90>::render_text(full, font, x, 0, text, colors);
+
+    FB ring;
+    ring.clear(0x55);
+    std::size_t pos = 0;
+    MarqueeRenderer<FB, Font> marquee(ring, font, x, colors);
+    auto next_char = [&]{return pos < text.size()?decode_utf8(text, pos):-1;};
+    for (unsigned int position = 0; position + FB::height <= length; position += step) {
+        marquee.update(position, next_char);
+        for (unsigned int r = position; r < position + FB::height; ++r) {
+            for (unsigned int c = 0; c < FB::width; ++c) {
+                CHECK_EQ(ring.get_pixel(c, r % FB::height), full.get_pixel(c, r));
+            }
+        }
+    }
+}
+
+int main() {
+    test_marquee<FrameBuffer<8, 16> >(font_6p, 7, {}, 1);
+    test_marquee<FrameBuffer<8, 16> >(font_6p, 7, {}, 4);
+    test_marquee<FrameBuffer<8, 12> >(font_5x3, 5, {}, 1);
+    test_marquee<FrameBuffer<16, 13> >(font_6p, 10, {}, 1);
+    test_marquee<FrameBuffer<8, 16, Format::gray_blink_2bit> >(font_6p, 7, {2, 1}, 3);
+    return CHECK_RESULT();
+}
@@ -0,0 +1,50 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+
+using namespace DotMatrix;
+
+static int calls_a = 0;
+static int calls_b = 0;
+static int id_a = -1;
+
+//tasks schedule and cancel tasks from the auto drive interrupt
+static void test_from_task() {
+    using FB = FrameBuffer<12, 8>;
+    static constexpr Driver<FB, Orientation::landscape> driver = {};
+    static FB fb = {};
+    static State st;
+    Simulator::reset();
+    enable_auto_drive(driver, st, fb);
+    id_a = schedule_task([]{
+        if (++calls_a == 3) {
+            CHECK(cancel_task(id_a));
+            CHECK(schedule_task([]{++calls_b;}, 5) >= 0);
+        }
+    }, 10, 10);
+    CHECK(id_a >= 0);
+    Simulator::run_auto_drive(100);
+    CHECK_EQ(calls_a, 3);
+    CHECK_EQ(calls_b, 1);
+    CHECK(!cancel_task(id_a));
+    disable_auto_drive();
+}
+
+//capacity is limited, freed slots are reused
+static void test_capacity() {
+    Simulator::reset();
+    int ids[auto_drive_scheduler_capacity];
+    for (auto &id: ids) {
+        id = schedule_task([]{}, 1000);
+        CHECK(id >= 0);
+    }
+    CHECK_EQ(schedule_task([]{}, 1000), -1);
+    CHECK(cancel_task(ids[3]));
+    CHECK(schedule_task([]{}, 1000) >= 0);
+    Simulator::reset();
+}
+
+int main() {
+    test_from_task();
+    test_capacity();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,99 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+#include <cmath>
+
+using namespace DotMatrix;
+
+static bool near(double a, double b) {
+    return std::fabs(a - b) < 1e-9;
+}
+
+//every LED of a full monochrome frame is lit once per scan of 11 rows
+static void test_monochrome_duty() {
+    using FB = FrameBuffer<12, 8>;
+    constexpr Driver<FB, Orientation::landscape> driver = {};
+    FB fb = {};
+    fb.clear(1);
+    State st;
+    Simulator::reset();
+    for (unsigned int i = 0; i < 11 * 100; ++i) {
+        driver.drive(st, fb);
+        Simulator::tick();
+        unsigned int high = 0;
+        for (unsigned int l = 0; l < 11; ++l) high += Simulator::line_state(l) == Simulator::Line::high;
+        CHECK(high <= 1);
+    }
+    const auto &s = Simulator::stats();
+    CHECK_EQ(s.ticks, 1100UL);
+    for (unsigned int i = 0; i < DirectDrive::num_leds; ++i) CHECK(near(s.duty(i) * 11, 1.0));
+}
+
+//single pixel lights single LED
+static void test_single_pixel() {
+    using FB = FrameBuffer<12, 8>;
+    constexpr Driver<FB, Orientation::landscape> driver = {};
+    FB fb = {};
+    fb.set_pixel(5, 3, 1);
+    State st;
+    Simulator::reset();
+    std::bitset<DirectDrive::num_leds> lit;
+    for (unsigned int i = 0; i < 11; ++i) {
+        driver.drive(st, fb);
+        Simulator::tick();
+        lit |= Simulator::last_tick();
+    }
+    CHECK_EQ(lit.count(), 1U);
+    CHECK(lit[3 * 12 + 5]);
+    CHECK(Simulator::stats().duty(5, 3) > 0.0);
+    Simulator::reset();
+    CHECK_EQ(Simulator::stats().ticks, 0UL);
+    CHECK_EQ(Simulator::stats().duty(5, 3), 0.0);
+}
+
+//gray levels: off, low (1/22), high (2/22), blinking high (2/22 half of the time)
+static void test_gray_ratios() {
+    using FB = FrameBuffer<12, 8, Format::gray_blink_2bit>;
+    static constexpr Driver<FB, Orientation::landscape> driver = {};
+    static FB fb = {};
+    static State st;
+    for (unsigned int x = 0; x < 12; ++x) {
+        for (unsigned int y = 0; y < 8; ++y) fb.set_pixel(x, y, x % 4);
+    }
+    Simulator::reset();
+    enable_auto_drive(driver, st, fb);
+    CHECK_EQ(Simulator::run_auto_drive(22 * 1024 * 4), 22U * 1024 * 4);
+    const auto &s = Simulator::stats();
+    CHECK(near(s.duty(0, 0) * 22, 0.0));
+    CHECK(near(s.duty(1, 0) * 22, 1.0));
+    CHECK(near(s.duty(2, 0) * 22, 2.0));
+    CHECK(near(s.duty(3, 0) * 22, 1.0));
+    disable_auto_drive();
+    CHECK_EQ(Simulator::run_auto_drive(1), 0U);
+}
+
+//binary code modulation: duty is proportional to the value
+static void test_bcm_ratios() {
+    using FB = FrameBuffer<12, 8, Format::gray_bcm_4bit>;
+    static constexpr Driver<FB, Orientation::landscape> driver = {};
+    static FB fb = {};
+    static State st;
+    for (unsigned int x = 0; x < 12; ++x) {
+        for (unsigned int y = 0; y < 8; ++y) fb.set_pixel(x, y, x);
+    }
+    enable_auto_drive(driver, st, fb);
+    //first scan starts with the tick of the initial period
+    Simulator::run_auto_drive(11 * 4);
+    Simulator::reset();
+    Simulator::run_auto_drive(11 * 4 * 10);
+    const auto &s = Simulator::stats();
+    for (unsigned int x = 0; x < 12; ++x) CHECK(near(s.duty(x, 0) * 11 * 15, x));
+    disable_auto_drive();
+}
+
+int main() {
+    test_monochrome_duty();
+    test_single_pixel();
+    test_gray_ratios();
+    test_bcm_ratios();
+    return CHECK_RESULT();
+}
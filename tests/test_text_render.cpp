@@ -0,0 +1,60 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+#include <cstring>
+
+using namespace DotMatrix;
+
+using Glyph = ExtraGlyph<FontFaceP<7, 6> >;
+constexpr auto font_6p_ext = extend_font(font_6p, {
+    Glyph{U'č', {5, " x x  "
+                    "  x   "
+                    " xxx  "
+                    "x     "
+                    "x     "
+                    " xxx  "
+                    "      "}},
+    Glyph{U'ü', {6, "x  x  "
+                    "      "
+                    "x  x  "
+                    "x  x  "
+                    "x  x  "
+                    " xx   "
+                    "      "}},
+});
+constexpr auto font_6p_packed = pack_font<font_6p>();
+
+static_assert(IsRotatedFont<std::decay_t<decltype(rotated_font<Rotation::rot90, font_6p_ext>)> >::value);
+static_assert(font_metrics(rotated_font<Rotation::rot270, font_6p_ext>).char_width(U'ü') == 6);
+
+//text rendered by the font selected by render_text<font>() equals the text rendered
+//by the source font (per pixel rotation)
+template<Rotation rot, const auto &font>
+static void test_render(int x, int y) {
+    static const char *text = "Ahoj, čau! Grüß dich";
+    FrameBuffer<40, 110> a;
+    FrameBuffer<40, 110> b;
+    a.clear();
+    b.clear();
+    auto ra = TextRender<BltOp::copy, rot>::render_text(a, font, x, y, text);
+    auto rb = TextRender<BltOp::copy, rot>::template render_text<font>(b, x, y, text);
+    CHECK(ra == rb);
+    CHECK(std::memcmp(a.pixels, b.pixels, sizeof(a.pixels)) == 0);
+}
+
+template<const auto &font>
+static void test_font() {
+    test_render<Rotation::rot0, font>(0, 0);
+    test_render<Rotation::rot90, font>(7, 0);
+    test_render<Rotation::rot90, font>(20, 3);
+    test_render<Rotation::rot180, font>(39, 100);
+    test_render<Rotation::rot270, font>(0, 109);
+    test_render<Rotation::rot270, font>(-2, 100);
+}
+
+int main() {
+    test_font<font_6p>();
+    test_font<font_5x3>();
+    test_font<font_6p_ext>();
+    test_font<font_6p_packed>();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,78 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+#include <string>
+#include <vector>
+
+using namespace DotMatrix;
+
+constexpr auto metrics_6p = font_metrics(font_6p);
+static_assert(metrics_6p.text_width("Hello") == metrics_6p.text_width("Hel") + metrics_6p.text_width("lo"));
+static_assert(measure_text(metrics_6p, "Hello world", 1000).first == metrics_6p.text_width("Hello world"));
+static_assert(measure_text(metrics_6p, "Hello world", 30).second == 2 * metrics_6p.height);
+static_assert(align_offset(Align::center, 5, 12) == 3);
+static_assert(align_offset(Align::right, 14, 12) == -2);
+
+struct Line {
+    std::string text;
+    unsigned int width;
+    bool operator==(const Line &other) const {
+        return text == other.text && width == other.width;
+    }
+};
+
+template<typename Metrics>
+static std::vector<Line> wrap(const Metrics &metrics, std::string_view text, unsigned int max_width) {
+    std::vector<Line> out;
+    unsigned int n = wrap_text(metrics, text, max_width, [&](const TextLine &l) {
+        out.push_back({std::string(text.substr(l.begin, l.end - l.begin)), l.width});
+    });
+    CHECK_EQ(n, out.size());
+    return out;
+}
+
+//every glyph is 3 pixels wide, 'W' is 10 pixels wide
+static FontMetrics<> test_metrics() {
+    FontMetrics<> m;
+    for (auto &w: m.width) w = 3;
+    m.width['W' - 32] = 10;
+    m.height = 6;
+    return m;
+}
+
+static void test_break_at_space() {
+    auto m = test_metrics();
+    CHECK((wrap(m, "aa bb", 12) == std::vector<Line>{{"aa", 6}, {"bb", 6}}));
+    CHECK((wrap(m, "aa   bb cc", 21) == std::vector<Line>{{"aa   bb", 21}, {"cc", 6}}));
+    CHECK((wrap(m, "ab\n\ncd", 100) == std::vector<Line>{{"ab", 6}, {"", 0}, {"cd", 6}}));
+}
+
+//rest of the word moved to the next line is broken again when it doesn't fit
+static void test_break_long_word() {
+    auto m = test_metrics();
+    CHECK((wrap(m, "a bbbb", 11) == std::vector<Line>{{"a", 3}, {"bbb", 9}, {"b", 3}}));
+    CHECK((wrap(m, "a bW", 11) == std::vector<Line>{{"a", 3}, {"b", 3}, {"W", 10}}));
+    CHECK((wrap(m, "a bbW c", 12) == std::vector<Line>{{"a", 3}, {"bb", 6}, {"W", 10}, {"c", 3}}));
+}
+
+//lines fit the box unless they consist of single character, don't begin or end with
+//a space and their width matches the measured width
+static void test_properties() {
+    const std::string_view text = "The quick brown fox   jumps over\nthe lazy dog. Supercalifragilistic  end  ";
+    for (unsigned int max_width = 4; max_width < 64; ++max_width) {
+        for (const Line &l: wrap(metrics_6p, text, max_width)) {
+            CHECK_EQ(l.width, metrics_6p.text_width(l.text));
+            if (l.text.size() > 1) CHECK(l.width <= max_width);
+            if (!l.text.empty()) {
+                CHECK(l.text.front() != ' ');
+                CHECK(l.text.back() != ' ');
+            }
+        }
+    }
+}
+
+int main() {
+    test_break_at_space();
+    test_break_long_word();
+    test_properties();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,58 @@
+#include "DotMatrixSim.h"
+#include "check.h"
+#include <vector>
+
+using namespace DotMatrix;
+
+static std::vector<int> decode(std::string_view text) {
+    std::vector<int> out;
+    std::size_t pos = 0;
+    while (pos < text.size()) out.push_back(decode_utf8(text, pos));
+    return out;
+}
+
+constexpr int decode_first(std::string_view text) {
+    std::size_t pos = 0;
+    return decode_utf8(text, pos);
+}
+
+static_assert(decode_first("A") == 'A');
+static_assert(decode_first("\xC3\xA1") == 0xE1);
+static_assert(decode_first("\xE2\x82\xAC") == 0x20AC);
+static_assert(decode_first("\xF0\x9F\x98\x80") == 0x1F600);
+static_assert(decode_first("\xF4\x8F\xBF\xBF") == 0x10FFFF);
+
+static void test_valid() {
+    CHECK((decode("a\xC3\xA1\xE2\x82\xAC\xF0\x9F\x98\x80z") == std::vector<int>{'a', 0xE1, 0x20AC, 0x1F600, 'z'}));
+    CHECK((decode("\xC2\x80\xDF\xBF\xE0\xA0\x80\xED\x9F\xBF\xEE\x80\x80")
+            == std::vector<int>{0x80, 0x7FF, 0x800, 0xD7FF, 0xE000}));
+}
+
+static void test_invalid() {
+    //lead bytes 0xF8-0xFF, stray continuation
+    CHECK((decode("\xF8\x80\x80\x80") == std::vector<int>{'?', '?', '?', '?'}));
+    CHECK((decode("\xFF" "a") == std::vector<int>{'?', 'a'}));
+    CHECK((decode("\x80" "a") == std::vector<int>{'?', 'a'}));
+    //overlong forms
+    CHECK((decode("\xC0\xAF") == std::vector<int>{'?'}));
+    CHECK((decode("\xC1\xBF") == std::vector<int>{'?'}));
+    CHECK((decode("\xE0\x80\xAF") == std::vector<int>{'?'}));
+    CHECK((decode("\xE0\x9F\xBF") == std::vector<int>{'?'}));
+    CHECK((decode("\xF0\x80\x80\xAF") == std::vector<int>{'?'}));
+    CHECK((decode("\xF0\x8F\xBF\xBF") == std::vector<int>{'?'}));
+    //surrogates
+    CHECK((decode("\xED\xA0\x80") == std::vector<int>{'?'}));
+    CHECK((decode("\xED\xBF\xBF") == std::vector<int>{'?'}));
+    //beyond U+10FFFF
+    CHECK((decode("\xF4\x90\x80\x80") == std::vector<int>{'?'}));
+    CHECK((decode("\xF7\xBF\xBF\xBF") == std::vector<int>{'?'}));
+    //truncated sequence, the next character is kept
+    CHECK((decode("\xE2\x82" "a") == std::vector<int>{'?', 'a'}));
+    CHECK((decode("\xE2") == std::vector<int>{'?'}));
+}
+
+int main() {
+    test_valid();
+    test_invalid();
+    return CHECK_RESULT();
+}
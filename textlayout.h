@@ -0,0 +1,314 @@
+#pragma once
+#include <array>
+#include <string_view>
+namespace DotMatrix {
+
+///Advance widths of glyphs of a font, created by font_metrics()
+/**
+ * Text is measured by table lookups, glyphs are never touched.
+ *
+ * @tparam N count of extra glyphs (ExtendedFont)
+ */
+template<std::size_t N = 0>
+struct FontMetrics {
+    ///advance width of ASCII characters 32-127
+    uint8_t width[96] = {};
+    ///height of line in pixels (in direction of the rotation for RotatedFont)
+    uint8_t height = 0;
+    ///sorted code points of extra glyphs
+    std::array<char32_t, N> codes = {};
+    ///advance width of extra glyphs
+    std::array<uint8_t, N> extra_width = {};
+
+    ///retrieve advance width of the character
+    /**
+     * @param code code point. Characters without glyph are measured as the
+     * glyph which is rendered instead (see do_for_character())
+     * @return width in pixels
+     */
+    constexpr unsigned int char_width(int code) const {
+        if constexpr(N > 0) {
+            if (code > 127) {
+                std::size_t l = 0;
+                std::size_t h = N;
+                while (l < h) {
+                    std::size_t m = (l + h) / 2;
+                    if (codes[m] < static_cast<char32_t>(code)) l = m + 1;
+                    else if (codes[m] > static_cast<char32_t>(code)) h = m;
+                    else return extra_width[m];
+                }
+            }
+        }
+        if (code < 33) code = 32;
+        else if (code > 127) code = '?';
+        return width[code - 32];
+    }
+
+    ///measure text
+    /**
+     * @param text text (UTF-8), new lines are not handled (see wrap_text())
+     * @return width in pixels
+     */
+    constexpr unsigned int text_width(std::string_view text) const {
+        unsigned int w = 0;
+        std::size_t pos = 0;
+        while (pos < text.size()) w += char_width(decode_utf8(text, pos));
+        return w;
+    }
+};
+
+///Build metrics of the font at compile time
+/**
+ * @param font font (fixed, proportional, packed or rotated)
+ * @return FontMetrics
+ *
+ * @code
+ * constexpr auto font_6p_metrics = DotMatrix::font_metrics(DotMatrix::font_6p);
+ * @endcode
+ */
+template<typename Font>
+constexpr FontMetrics<> font_metrics(const Font &font) {
+    using Spec = FontFaceSpec<std::decay_t<decltype(font[0])> >;
+    using Face = std::decay_t<decltype(Spec{font[0]}.get_face())>;
+    FontMetrics<> out = {};
+    for (unsigned int i = 0; i < 96; ++i) {
+        out.width[i] = Spec{font[i]}.get_width();
+    }
+    if constexpr(IsRotatedFont<Font>::value) {
+        constexpr Rotation rot = IsRotatedFont<Font>::rotation;
+        constexpr bool swap = rot == Rotation::rot90 || rot == Rotation::rot270;
+        out.height = static_cast<uint8_t>(swap?Face::get_width():Face::get_height());
+    } else {
+        out.height = static_cast<uint8_t>(Face::get_height());
+    }
+    return out;
+}
+
+///Build metrics of the extended font at compile time
+template<typename Font, std::size_t N>
+constexpr FontMetrics<N> font_metrics(const ExtendedFont<Font, N> &font) {
+    using Spec = FontFaceSpec<typename ExtendedFont<Font, N>::Face>;
+    FontMetrics<> base = font_metrics(*font.base);
+    FontMetrics<N> out = {};
+    for (unsigned int i = 0; i < 96; ++i) out.width[i] = base.width[i];
+    out.height = base.height;
+    for (std::size_t i = 0; i < N; ++i) {
+        out.codes[i] = font.codes[i];
+        out.extra_width[i] = Spec{font.glyphs[i]}.get_width();
+    }
+    return out;
+}
+
+///Horizontal alignment of text lines
+enum class Align {
+    left,
+    center,
+    right
+};
+
+///Line of wrapped text
+struct TextLine {
+    ///first byte of the line in the text
+    std::size_t begin = 0;
+    ///end of the line in the text (trailing spaces are excluded)
+    std::size_t end = 0;
+    ///width of the line in pixels
+    unsigned int width = 0;
+};
+
+///Calculate offset of the line in the box
+/**
+ * @param align alignment
+ * @param line_width width of the line
+ * @param box_width width of the box
+ * @return offset from the left side of the box (negative when the line is wider)
+ */
+constexpr int align_offset(Align align, unsigned int line_width, unsigned int box_width) {
+    int space = static_cast<int>(box_width) - static_cast<int>(line_width);
+    switch (align) {
+        default:
+        case Align::left: return 0;
+        case Align::center: return space / 2;
+        case Align::right: return space;
+    }
+}
+
+///Word-wrap text into lines
+/**
+ * Lines are broken at spaces, words wider than the box are broken between
+ * characters. '\n' breaks the line. Spaces at the wrap are skipped, they are
+ * neither at the end nor at the beginning of lines. The text is processed in one pass.
+ *
+ * @param metrics metrics of the font
+ * @param text text (UTF-8)
+ * @param max_width width of the box
+ * @param fn function called for every line with TextLine
+ * @return count of lines
+ */
+template<typename Metrics, typename Fn>
+constexpr unsigned int wrap_text(const Metrics &metrics, std::string_view text, unsigned int max_width, Fn &&fn) {
+    constexpr std::size_t none = static_cast<std::size_t>(-1);
+    unsigned int lines = 0;
+    std::size_t line_begin = 0;
+    unsigned int width = 0;
+    //end of the last visible character
+    std::size_t ink_end = 0;
+    unsigned int ink_width = 0;
+    //last break opportunity: end of the line before spaces and start of the next line
+    std::size_t brk_end = none;
+    unsigned int brk_width = 0;
+    std::size_t brk_next = 0;
+    unsigned int brk_next_width = 0;
+    bool prev_space = false;
+    auto emit = [&](std::size_t end, unsigned int w) {
+        fn(TextLine{line_begin, end, w});
+        ++lines;
+        brk_end = none;
+        prev_space = false;
+    };
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        std::size_t cpos = pos;
+        int c = decode_utf8(text, pos);
+        if (c == '\n') {
+            emit(ink_end, ink_width);
+            line_begin = ink_end = pos;
+            width = ink_width = 0;
+            continue;
+        }
+        if (c == ' ') {
+            if (!prev_space) {
+                brk_end = cpos;
+                brk_width = width;
+            }
+            width += metrics.char_width(c);
+            brk_next = pos;
+            brk_next_width = width;
+            prev_space = true;
+            continue;
+        }
+        unsigned int w = metrics.char_width(c);
+        if (width + w > max_width && width > 0 && brk_end != none) {
+            //line of spaces only is not emitted
+            if (brk_end > line_begin) emit(brk_end, brk_width);
+            brk_end = none;
+            line_begin = brk_next;
+            width -= brk_next_width;
+            //rest of the word moved to the new line
+            ink_width = width;
+        }
+        if (width + w > max_width && width > 0) {
+            //word doesn't fit even on its own line
+            emit(ink_end, ink_width);
+            line_begin = cpos;
+            width = 0;
+        }
+        width += w;
+        ink_end = pos;
+        ink_width = width;
+        prev_space = false;
+    }
+    if (!text.empty()) emit(ink_end, ink_width);
+    return lines;
+}
+
+///Measure text wrapped into a box
+/**
+ * @param metrics metrics of the font
+ * @param text text
+ * @param max_width width of the box
+ * @return width of the widest line and total height of lines
+ */
+template<typename Metrics>
+constexpr std::pair<unsigned int, unsigned int> measure_text(const Metrics &metrics, std::string_view text,
+        unsigned int max_width) {
+    unsigned int w = 0;
+    unsigned int n = wrap_text(metrics, text, max_width, [&](const TextLine &l) {
+        w = std::max(w, l.width);
+    });
+    return {w, n * metrics.height};
+}
+
+///Render text wrapped and aligned in a box
+/**
+ * Lines are stacked in direction of the rotation of the renderer
+ * (downwards for rot0, to the left for rot90, upwards for rot180,
+ * to the right for rot270)
+ *
+ * @tparam Render TextRender
+ * @param fb frame buffer
+ * @param font font
+ * @param metrics metrics of the font
+ * @param x starting x coordinate (as render_text())
+ * @param y starting y coordinate (as render_text())
+ * @param box_width width of the box in direction of the text
+ * @param text text (UTF-8)
+ * @param align alignment
+ * @param cols colors
+ * @return count of lines
+ */
+template<typename Render, typename FrameBuffer, typename Font, typename Metrics>
+unsigned int render_text_box(FrameBuffer &fb, const Font &font, const Metrics &metrics,
+        int x, int y, unsigned int box_width, std::string_view text, Align align = Align::left,
+        const ColorMap &cols = {}) {
+    constexpr Rotation rot = Render::rotation;
+    int across = 0;
+    return wrap_text(metrics, text, box_width, [&](const TextLine &l) {
+        int along = align_offset(align, l.width, box_width);
+        int cx = x;
+        int cy = y;
+        if constexpr(rot == Rotation::rot0) {
+            cx += along; cy += across;
+        } else if constexpr(rot == Rotation::rot90) {
+            cx -= across; cy += along;
+        } else if constexpr(rot == Rotation::rot180) {
+            cx -= along; cy -= across;
+        } else {
+            cx += across; cy -= along;
+        }
+        Render::render_text(fb, font, cx, cy, text.substr(l.begin, l.end - l.begin), cols);
+        across += metrics.height;
+    });
+}
+
+///Render constant text into a bitmap at compile time
+/**
+ * The width of the bitmap is the width of the text, the height is the height
+ * of the font. Draw the bitmap by BitBlt or Bitmap::draw(), the text rendering
+ * code is not needed at runtime.
+ *
+ * @tparam font font (fixed, proportional, packed or extended). It must be declared
+ * as constexpr variable
+ * @param str lambda function returning the text (UTF-8)
+ * @return Bitmap
+ *
+ * @code
+ * constexpr auto label = DotMatrix::render_static_text<DotMatrix::font_6p>([]{return "Hello";});
+ * @endcode
+ */
+template<const auto &font, typename Str>
+constexpr auto render_static_text(Str str) {
+    static_assert(!IsRotatedFont<std::decay_t<decltype(font)> >::value, "Use Rotation of BitBlt to rotate the text");
+    constexpr std::string_view text = str();
+    constexpr auto metrics = font_metrics(font);
+    constexpr unsigned int w = metrics.text_width(text);
+    static_assert(w > 0, "Text is empty");
+    Bitmap<w, metrics.height> out = {};
+    unsigned int x = 0;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        x += do_for_character(font, decode_utf8(text, pos), [&](auto spec) {
+            const auto &face = spec.get_face();
+            unsigned int gw = std::min<unsigned int>(face.get_width(), w - x);
+            for (unsigned int gy = 0; gy < metrics.height; ++gy) {
+                for (unsigned int gx = 0; gx < gw; ++gx) {
+                    if (face.get_pixel(gx, gy)) out.set_pixel(x + gx, gy);
+                }
+            }
+            return spec.get_width();
+        });
+    }
+    return out;
+}
+
+}
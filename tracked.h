@@ -0,0 +1,145 @@
+#pragma once
+#include <type_traits>
+#include <utility>
+namespace DotMatrix {
+
+///Region of the frame buffer changed since the last clear_dirty()
+/**
+ * Coordinates are inclusive. Region is empty when x0 > x1
+ */
+struct DirtyRegion {
+    unsigned int x0 = 1;
+    unsigned int y0 = 1;
+    unsigned int x1 = 0;
+    unsigned int y1 = 0;
+
+    ///test whether region is empty
+    constexpr bool empty() const {
+        return x0 > x1;
+    }
+
+    ///extend region to include a rectangle (coordinates are inclusive)
+    constexpr void extend(unsigned int rx0, unsigned int ry0, unsigned int rx1, unsigned int ry1) {
+        if (empty()) {
+            *this = {rx0, ry0, rx1, ry1};
+        } else {
+            x0 = std::min(x0, rx0);
+            y0 = std::min(y0, ry0);
+            x1 = std::max(x1, rx1);
+            y1 = std::max(y1, ry1);
+        }
+    }
+};
+
+///Frame buffer which records bounding box of changed pixels
+/**
+ * It can be used everywhere the FrameBuffer is used. set_pixel() extends
+ * the bounding box by an empty check and four min/max updates, draw_line(),
+ * draw_box() and clear() mark their area once. Blit kernels (BitBlt, TextRender) mark rectangles they write.
+ *
+ * Consumers (streaming, copying to another buffer) can process only bytes
+ * returned by dirty_bytes() and call clear_dirty() afterwards
+ *
+ * @note direct writes to pixels are not tracked, call mark_dirty()
+ */
+template<unsigned int _width, unsigned int _height, Format _format = Format::monochrome_1bit, Order _order = Order::msb_to_lsb>
+struct TrackedFrameBuffer: FrameBuffer<_width, _height, _format, _order> {
+
+    using Base = FrameBuffer<_width, _height, _format, _order>;
+    using Base::width;
+    using Base::height;
+    using Base::bits_per_pixel;
+
+    ///set value of pixel, mark it dirty
+    constexpr void set_pixel(unsigned int x, unsigned int y, uint8_t value) {
+        if (x < width && y < height) {
+            extend(x, y, x, y);
+            Base::set_pixel(x, y, value);
+        }
+    }
+
+    ///clear buffer, whole buffer is dirty
+    constexpr void clear(uint8_t value = 0) {
+        extend(0, 0, width - 1, height - 1);
+        Base::clear(value);
+    }
+
+    ///draw line, mark its bounding box
+    constexpr void draw_line(int x0, int y0, int x1, int y1, uint8_t color) {
+        mark_dirty(x0, y0, x1, y1);
+        Base::draw_line(x0, y0, x1, y1, color);
+    }
+
+    ///draw box, mark it
+    constexpr void draw_box(int x0, int y0, int x1, int y1, uint8_t color) {
+        mark_dirty(x0, y0, x1, y1);
+        Base::draw_box(x0, y0, x1, y1, color);
+    }
+
+    ///mark rectangle dirty
+    /**
+     * @param x0 x-coord of a corner
+     * @param y0 y-coord of a corner
+     * @param x1 x-coord of opposite corner
+     * @param y1 y-coord of opposite corner
+     *
+     * @note all coordinates are included, rectangle is clipped
+     */
+    constexpr void mark_dirty(int x0, int y0, int x1, int y1) {
+        if (x0 > x1) std::swap(x0, x1);
+        if (y0 > y1) std::swap(y0, y1);
+        if (x1 < 0 || y1 < 0 || x0 >= static_cast<int>(width) || y0 >= static_cast<int>(height)) return;
+        extend(static_cast<unsigned int>(std::max(x0, 0)),
+               static_cast<unsigned int>(std::max(y0, 0)),
+               std::min<unsigned int>(x1, width - 1),
+               std::min<unsigned int>(y1, height - 1));
+    }
+
+    ///retrieve dirty region
+    constexpr const DirtyRegion &dirty() const {
+        return _dirty;
+    }
+
+    ///retrieve dirty bytes of pixels
+    /**
+     * @return pair of indices (begin, end) to pixels. Rows between the first
+     * and the last dirty row are included whole. Empty region returns (0,0)
+     */
+    constexpr std::pair<unsigned int, unsigned int> dirty_bytes() const {
+        if (_dirty.empty()) return {0, 0};
+        unsigned int first = (_dirty.y0 * width + _dirty.x0) * bits_per_pixel;
+        unsigned int last = (_dirty.y1 * width + _dirty.x1 + 1) * bits_per_pixel;
+        return {first / 8, (last + 7) / 8};
+    }
+
+    ///reset dirty region
+    constexpr void clear_dirty() {
+        _dirty = {};
+    }
+
+protected:
+    DirtyRegion _dirty = {};
+
+    constexpr void extend(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1) {
+        _dirty.extend(x0, y0, x1, y1);
+    }
+};
+
+///determines whether frame buffer tracks changes
+template<typename FrameBuffer, typename = void>
+struct HasDirtyTracking : std::false_type {};
+
+template<typename FrameBuffer>
+struct HasDirtyTracking<FrameBuffer, std::void_t<
+        decltype(std::declval<FrameBuffer &>().mark_dirty(0, 0, 0, 0))> >
+    : std::true_type {};
+
+///mark rectangle dirty if the frame buffer tracks changes, otherwise nothing
+template<typename FrameBuffer>
+constexpr void mark_dirty(FrameBuffer &fb, int x0, int y0, int x1, int y1) {
+    if constexpr(HasDirtyTracking<FrameBuffer>::value) {
+        fb.mark_dirty(x0, y0, x1, y1);
+    }
+}
+
+}